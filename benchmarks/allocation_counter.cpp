@@ -0,0 +1,80 @@
+#include "allocation_counter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include <malloc.h>
+
+namespace
+{
+std::atomic<std::size_t> allocations{0};
+std::atomic<std::size_t> bytes_in_use{0};
+
+void* counted_allocation(std::size_t size)
+{
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	if (void* memory = std::malloc(size == 0 ? 1 : size))
+	{
+		bytes_in_use.fetch_add(::malloc_usable_size(memory), std::memory_order_relaxed);
+		return memory;
+	}
+	throw std::bad_alloc{};
+}
+
+void counted_free(void* memory)
+{
+	if (!memory)
+		return;
+	bytes_in_use.fetch_sub(::malloc_usable_size(memory), std::memory_order_relaxed);
+	std::free(memory);
+}
+}
+
+namespace fc
+{
+namespace bench
+{
+
+std::size_t nr_of_allocations()
+{
+	return allocations.load(std::memory_order_relaxed);
+}
+
+std::size_t heap_bytes_in_use()
+{
+	return bytes_in_use.load(std::memory_order_relaxed);
+}
+
+}
+}
+
+void* operator new(std::size_t size)
+{
+	return counted_allocation(size);
+}
+
+void* operator new[](std::size_t size)
+{
+	return counted_allocation(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+	counted_free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	counted_free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+	counted_free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+	counted_free(memory);
+}
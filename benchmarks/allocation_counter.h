@@ -0,0 +1,25 @@
+#ifndef BENCHMARKS_ALLOCATION_COUNTER_H_
+#define BENCHMARKS_ALLOCATION_COUNTER_H_
+
+#include <cstddef>
+
+namespace fc
+{
+namespace bench
+{
+
+/**
+ * \brief number of calls of global operator new since program start, from all threads.
+ *
+ * The benchmark executable replaces the global operator new to count allocations.
+ * Take the difference before and after the code measured.
+ */
+std::size_t nr_of_allocations();
+
+/// bytes currently allocated through global operator new, including allocator overhead.
+std::size_t heap_bytes_in_use();
+
+}
+}
+
+#endif /* BENCHMARKS_ALLOCATION_COUNTER_H_ */
@@ -0,0 +1,50 @@
+#include <benchmark/benchmark.h>
+
+#include <flexcore/utils/net/bridge.hpp>
+
+#include <string>
+#include <vector>
+
+namespace fc
+{
+namespace bench
+{
+
+// Throughput of bridges over the loopback interface.
+// Each iteration sends one batch of range(0) tokens of range(1) bytes,
+// the receiver takes all batches in the benchmark thread like a work tick would.
+
+template <net::protocol transport>
+void bridge_throughput(benchmark::State& state)
+{
+	const auto tokens_per_batch = static_cast<std::size_t>(state.range(0));
+	const auto token_size = static_cast<std::size_t>(state.range(1));
+
+	net::bridge_receiver receiver{net::endpoint{transport, "127.0.0.1", 0}};
+	net::bridge_sender sender{net::endpoint{transport, "127.0.0.1", receiver.local_port()}};
+	const auto batch = net::encode_batch(
+			std::vector<std::string>(tokens_per_batch, std::string(token_size, 'x')));
+
+	std::size_t received = 0;
+	while (state.KeepRunning())
+	{
+		sender.send(batch);
+		receiver.take_all([&received](const std::string& message)
+				{
+					received += net::decode_batch(message).size();
+				});
+	}
+	sender.flush();
+	benchmark::DoNotOptimize(received);
+
+	state.SetItemsProcessed(state.iterations() * tokens_per_batch);
+	state.SetBytesProcessed(state.iterations() * batch.size());
+}
+
+BENCHMARK_TEMPLATE(bridge_throughput, net::protocol::tcp)
+		->Args({1, 8})->Args({64, 8})->Args({1024, 8})->Args({64, 1024});
+BENCHMARK_TEMPLATE(bridge_throughput, net::protocol::udp)
+		->Args({1, 8})->Args({64, 8})->Args({1024, 8})->Args({32, 1024});
+
+}
+}
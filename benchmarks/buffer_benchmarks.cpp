@@ -0,0 +1,375 @@
+#include <benchmark/benchmark.h>
+
+#include <flexcore/core/token_pool.hpp>
+#include <flexcore/infrastructure.hpp>
+#include <flexcore/extended/nodes/region_worker_node.hpp>
+#include <flexcore/scheduler/clock.hpp>
+
+#include "allocation_counter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace fc
+{
+namespace bench
+{
+
+// Benchmarks of event_buffer and state_buffer between regions created by infrastructure.
+// The regions are ticked by the benchmark thread in the same order as cycle_control does,
+// one benchmark iteration is one cycle of min_tick_length.
+
+namespace
+{
+/// token carrying the cycle and wall time it was produced at and a payload of variable size.
+struct stamped_token
+{
+	std::uint64_t cycle;
+	wall_clock::steady::time_point sent;
+	std::vector<char> payload;
+};
+
+/// ticks regions like cycle_control, but without threads and without waiting.
+class region_driver
+{
+public:
+	void add(std::shared_ptr<parallel_region> region) { regions.push_back(std::move(region)); }
+
+	/// sends switch ticks to all regions due this cycle, then work ticks.
+	void run_cycle()
+	{
+		const auto now = thread::cycle_control::min_tick_length * cycle;
+		for (auto& region : regions)
+			if (now % region->get_duration() == virtual_clock::duration::zero())
+				region->ticks.switch_buffers();
+		for (auto& region : regions)
+			if (now % region->get_duration() == virtual_clock::duration::zero())
+				region->ticks.in_work()();
+		++cycle;
+	}
+
+	std::uint64_t current_cycle() const { return cycle; }
+
+private:
+	std::vector<std::shared_ptr<parallel_region>> regions;
+	std::uint64_t cycle = 0;
+};
+
+/// latency statistics collected by consumers.
+struct latency
+{
+	void add(const region_driver& driver, const stamped_token& token)
+	{
+		++received;
+		ticks += driver.current_cycle() - token.cycle;
+		wall += wall_clock::steady::now() - token.sent;
+		benchmark::DoNotOptimize(token.payload.data());
+	}
+
+	std::uint64_t received = 0;
+	std::uint64_t ticks = 0;
+	wall_clock::steady::duration wall = wall_clock::steady::duration::zero();
+};
+
+/// fires events_per_tick events on every work tick.
+class event_producer : public region_worker_node
+{
+public:
+	static constexpr auto default_name = "event_producer";
+
+	event_producer(const region_driver& driver, int events_per_tick, std::size_t payload_size,
+			const node_args& node)
+		: region_worker_node([this]() { produce(); }, node)
+		, driver(driver)
+		, events_per_tick(events_per_tick)
+		, payload(payload_size)
+		, out_event(this)
+	{
+	}
+
+	auto& out() { return out_event; }
+
+private:
+	void produce()
+	{
+		for (int i = 0; i < events_per_tick; ++i)
+			out_event.fire(stamped_token{driver.current_cycle(), wall_clock::steady::now(), payload});
+	}
+
+	const region_driver& driver;
+	const int events_per_tick;
+	const std::vector<char> payload;
+	event_source<stamped_token> out_event;
+};
+
+class event_consumer : public tree_base_node
+{
+public:
+	static constexpr auto default_name = "event_consumer";
+
+	event_consumer(const region_driver& driver, latency& stats, const node_args& node)
+		: tree_base_node(node)
+		, in_event(this, [&driver, &stats](const stamped_token& t) { stats.add(driver, t); })
+	{
+	}
+
+	auto& in() { return in_event; }
+
+private:
+	event_sink<stamped_token> in_event;
+};
+
+/// fires events_per_tick shared tokens on every work tick, optionally taken from a token_pool.
+class shared_event_producer : public region_worker_node
+{
+public:
+	static constexpr auto default_name = "shared_event_producer";
+
+	shared_event_producer(const region_driver& driver, int events_per_tick,
+			std::size_t payload_size, bool pooled, const node_args& node)
+		: region_worker_node([this]() { produce(); }, node)
+		, driver(driver)
+		, events_per_tick(events_per_tick)
+		, payload_size(payload_size)
+		, pooled(pooled)
+		, pool([payload_size]() { return stamped_token{0, {}, std::vector<char>(payload_size)}; })
+		, out_event(this)
+	{
+	}
+
+	auto& out() { return out_event; }
+
+private:
+	void produce()
+	{
+		for (int i = 0; i < events_per_tick; ++i)
+		{
+			if (pooled)
+				out_event.fire(pool.make([this](stamped_token& token)
+						{
+							token.cycle = driver.current_cycle();
+							token.sent = wall_clock::steady::now();
+						}));
+			else
+				out_event.fire(share(stamped_token{driver.current_cycle(),
+						wall_clock::steady::now(), std::vector<char>(payload_size)}));
+		}
+	}
+
+	const region_driver& driver;
+	const int events_per_tick;
+	const std::size_t payload_size;
+	const bool pooled;
+	token_pool<stamped_token> pool;
+	event_source<shared<stamped_token>> out_event;
+};
+
+class shared_event_consumer : public tree_base_node
+{
+public:
+	static constexpr auto default_name = "shared_event_consumer";
+
+	shared_event_consumer(const region_driver& driver, latency& stats, const node_args& node)
+		: tree_base_node(node)
+		, in_event(this, [&driver, &stats](const stamped_token& t) { stats.add(driver, t); })
+	{
+	}
+
+	auto& in() { return in_event; }
+
+private:
+	event_sink<shared<stamped_token>> in_event;
+};
+
+/// provides a new token, whenever it is pulled.
+class state_producer : public tree_base_node
+{
+public:
+	static constexpr auto default_name = "state_producer";
+
+	state_producer(const region_driver& driver, std::size_t payload_size, const node_args& node)
+		: tree_base_node(node)
+		, out_state(this, [&driver, payload_size]()
+				{
+					return stamped_token{driver.current_cycle(), wall_clock::steady::now(),
+							std::vector<char>(payload_size)};
+				})
+	{
+	}
+
+	auto& out() { return out_state; }
+
+private:
+	state_source<stamped_token> out_state;
+};
+
+/// pulls its input pulls_per_tick times on every work tick.
+class state_consumer : public region_worker_node
+{
+public:
+	static constexpr auto default_name = "state_consumer";
+
+	state_consumer(const region_driver& driver, latency& stats, int pulls_per_tick,
+			const node_args& node)
+		: region_worker_node([this, &driver, &stats, pulls_per_tick]()
+				{
+					for (int i = 0; i < pulls_per_tick; ++i)
+						stats.add(driver, in_state.get());
+				}, node)
+		, in_state(this)
+	{
+	}
+
+	auto& in() { return in_state; }
+
+private:
+	state_sink<stamped_token> in_state;
+};
+
+virtual_clock::duration consumer_tick(bool slow_consumer)
+{
+	return slow_consumer ? thread::cycle_control::medium_tick : thread::cycle_control::fast_tick;
+}
+
+/// runs cycles while the benchmark is running and reports latency and allocations.
+void run_and_report(benchmark::State& state, region_driver& driver, latency& stats,
+		std::size_t tokens_per_cycle)
+{
+	// first cycles fill the buffers and allocate their storage,
+	// they also deliver default constructed states, which would distort latency.
+	for (int i = 0; i < 100; ++i)
+		driver.run_cycle();
+	stats = latency{};
+	const auto allocations_before = nr_of_allocations();
+	while (state.KeepRunning())
+		driver.run_cycle();
+	const auto allocations = nr_of_allocations() - allocations_before;
+
+	state.SetItemsProcessed(state.iterations() * tokens_per_cycle);
+	const double received = static_cast<double>(std::max<std::uint64_t>(stats.received, 1));
+	state.counters["latency_ticks"] = static_cast<double>(stats.ticks) / received;
+	state.counters["latency_us"] = std::chrono::duration<double, std::micro>(stats.wall).count()
+			/ received;
+	state.counters["allocs_per_tick"] = static_cast<double>(allocations)
+			/ static_cast<double>(state.iterations());
+	state.counters["received_per_tick"] = static_cast<double>(stats.received)
+			/ static_cast<double>(state.iterations());
+}
+}
+
+/**
+ * Events crossing from a producer region to a consumer region through an event_buffer.
+ * range(0) events per tick with range(1) bytes payload,
+ * the consumer region runs with medium_tick instead of fast_tick if range(2) is set.
+ */
+void event_buffer_regions(benchmark::State& state)
+{
+	infrastructure infra;
+	region_driver driver;
+	auto producer_region = infra.add_region("producer", thread::cycle_control::fast_tick);
+	auto consumer_region = infra.add_region("consumer", consumer_tick(state.range(2)));
+	driver.add(producer_region);
+	driver.add(consumer_region);
+
+	latency stats;
+	auto& producer = infra.node_owner().make_child<event_producer>(producer_region,
+			driver, static_cast<int>(state.range(0)), static_cast<std::size_t>(state.range(1)));
+	auto& consumer = infra.node_owner().make_child<event_consumer>(consumer_region,
+			driver, stats);
+	producer.out() >> consumer.in();
+
+	run_and_report(state, driver, stats, static_cast<std::size_t>(state.range(0)));
+	state.SetBytesProcessed(state.iterations() * state.range(0) * state.range(1));
+}
+BENCHMARK(event_buffer_regions)
+		->Args({1, 0, 0})->Args({100, 0, 0})->Args({1, 1024, 0})->Args({100, 1024, 0})
+		->Args({1, 65536, 0})->Args({100, 0, 1})->Args({100, 1024, 1});
+
+/**
+ * Events from one producer region fanned out to range(0) consumer regions.
+ * Every consumer has its own event_buffer, each event carries range(1) bytes.
+ */
+void event_buffer_fan_out(benchmark::State& state)
+{
+	infrastructure infra;
+	region_driver driver;
+	auto producer_region = infra.add_region("producer", thread::cycle_control::fast_tick);
+	driver.add(producer_region);
+
+	latency stats;
+	auto& producer = infra.node_owner().make_child<event_producer>(producer_region,
+			driver, 10, static_cast<std::size_t>(state.range(1)));
+	for (int i = 0; i < state.range(0); ++i)
+	{
+		auto region = infra.add_region("consumer" + std::to_string(i),
+				thread::cycle_control::fast_tick);
+		driver.add(region);
+		producer.out() >> infra.node_owner().make_child<event_consumer>(region,
+				driver, stats).in();
+	}
+
+	run_and_report(state, driver, stats, static_cast<std::size_t>(10 * state.range(0)));
+}
+BENCHMARK(event_buffer_fan_out)->Args({2, 64})->Args({8, 64})->Args({32, 64});
+
+/**
+ * Shared tokens with range(1) bytes payload crossing between regions, range(0) per tick.
+ * Payloads are recycled by a token_pool if range(2) is set, otherwise allocated for every event.
+ */
+void event_buffer_pooled_payload(benchmark::State& state)
+{
+	infrastructure infra;
+	region_driver driver;
+	auto producer_region = infra.add_region("producer", thread::cycle_control::fast_tick);
+	auto consumer_region = infra.add_region("consumer", thread::cycle_control::fast_tick);
+	driver.add(producer_region);
+	driver.add(consumer_region);
+
+	latency stats;
+	auto& producer = infra.node_owner().make_child<shared_event_producer>(producer_region,
+			driver, static_cast<int>(state.range(0)), static_cast<std::size_t>(state.range(1)),
+			state.range(2) != 0);
+	auto& consumer = infra.node_owner().make_child<shared_event_consumer>(consumer_region,
+			driver, stats);
+	producer.out() >> consumer.in();
+
+	run_and_report(state, driver, stats, static_cast<std::size_t>(state.range(0)));
+	state.SetBytesProcessed(state.iterations() * state.range(0) * state.range(1));
+}
+BENCHMARK(event_buffer_pooled_payload)
+		->Args({10, 65536, 0})->Args({10, 65536, 1})
+		->Args({1, 4 << 20, 0})->Args({1, 4 << 20, 1});
+
+/**
+ * States with range(0) bytes payload pulled range(2) times per tick through a state_buffer.
+ * The consumer region runs with medium_tick instead of fast_tick if range(1) is set.
+ */
+void state_buffer_regions(benchmark::State& state)
+{
+	infrastructure infra;
+	region_driver driver;
+	auto producer_region = infra.add_region("producer", thread::cycle_control::fast_tick);
+	auto consumer_region = infra.add_region("consumer", consumer_tick(state.range(1)));
+	driver.add(producer_region);
+	driver.add(consumer_region);
+
+	latency stats;
+	auto& producer = infra.node_owner().make_child<state_producer>(producer_region,
+			driver, static_cast<std::size_t>(state.range(0)));
+	auto& consumer = infra.node_owner().make_child<state_consumer>(consumer_region,
+			driver, stats, static_cast<int>(state.range(2)));
+	producer.out() >> consumer.in();
+
+	run_and_report(state, driver, stats, static_cast<std::size_t>(state.range(2)));
+}
+BENCHMARK(state_buffer_regions)
+		->Args({0, 0, 1})->Args({1024, 0, 1})->Args({65536, 0, 1})
+		->Args({1024, 0, 10})->Args({1024, 1, 1});
+
+}
+}
+
+BENCHMARK_MAIN();
@@ -0,0 +1,265 @@
+#include "graph_generator.h"
+
+#include <flexcore/extended/nodes/buffer.hpp>
+#include <flexcore/extended/nodes/region_worker_node.hpp>
+#include <flexcore/extended/nodes/state_nodes.hpp>
+#include <flexcore/extended/nodes/terminal.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <deque>
+#include <random>
+#include <string>
+
+namespace fc
+{
+namespace bench
+{
+
+namespace
+{
+/// fires a single event on every work tick of its region.
+class event_generator : public region_worker_node
+{
+public:
+	static constexpr auto default_name = "event_generator";
+
+	explicit event_generator(const node_args& node)
+		: region_worker_node([this]() { out_event.fire(++count); }, node)
+		, count(0)
+		, out_event(this)
+	{
+	}
+
+	auto& out() { return out_event; }
+
+private:
+	int count;
+	event_source<int> out_event;
+};
+
+/// counts events received from any number of connections.
+class event_counter : public tree_base_node
+{
+public:
+	static constexpr auto default_name = "event_counter";
+
+	event_counter(std::uint64_t& counter, const node_args& node)
+		: tree_base_node(node)
+		, in_event(this, [&counter](int) { ++counter; })
+	{
+	}
+
+	auto& in() { return in_event; }
+
+private:
+	event_sink<int> in_event;
+};
+
+/// pulls state on every work tick of its region.
+class state_puller : public region_worker_node
+{
+public:
+	static constexpr auto default_name = "state_puller";
+
+	state_puller(std::uint64_t& counter, const node_args& node)
+		: region_worker_node([this, &counter]() { counter += in_state.get() != 0 ? 1 : 0; }, node)
+		, in_state(this)
+	{
+	}
+
+	auto& in() { return in_state; }
+
+private:
+	state_sink<int> in_state;
+};
+
+struct add
+{
+	int operator()(int a, int b) const { return a + b; }
+};
+
+using terminal_t = event_terminal<int>;
+using merge_t = merge_node<add, int(int, int), tree_base_node>;
+
+class graph_builder
+{
+public:
+	graph_builder(synthetic_graph& graph, std::size_t nr_of_nodes, std::uint32_t seed)
+		: graph(graph)
+		, planned_nodes(nr_of_nodes)
+		, random(seed)
+		, counters(graph.regions.size(), nullptr)
+	{
+	}
+
+	/// region of the i-th of planned_nodes nodes, nodes are assigned in contiguous blocks.
+	const std::shared_ptr<parallel_region>& block_region(std::size_t i) const
+	{
+		const auto index = std::min(i * graph.regions.size() / planned_nodes,
+				graph.regions.size() - 1);
+		return graph.regions[index];
+	}
+
+	const std::shared_ptr<parallel_region>& random_region()
+	{
+		std::uniform_int_distribution<std::size_t> pick(0, graph.regions.size() - 1);
+		return graph.regions[pick(random)];
+	}
+
+	std::size_t random_index(std::size_t end)
+	{
+		std::uniform_int_distribution<std::size_t> pick(0, end - 1);
+		return pick(random);
+	}
+
+	template <class node_t, class... args_t>
+	node_t& make(const std::shared_ptr<parallel_region>& region, args_t&&... args)
+	{
+		++graph.nr_of_nodes;
+		return graph.infra.node_owner().make_child<node_t>(region,
+				std::forward<args_t>(args)...);
+	}
+
+	template <class node_t, class... args_t>
+	node_t& make_named(const std::shared_ptr<parallel_region>& region, args_t&&... args)
+	{
+		++graph.nr_of_nodes;
+		return graph.infra.node_owner().make_child_named<node_t>(region,
+				"node" + std::to_string(graph.nr_of_nodes), std::forward<args_t>(args)...);
+	}
+
+	/// one counting sink per region, created on first use.
+	event_counter& counter(const std::shared_ptr<parallel_region>& region)
+	{
+		const auto index = static_cast<std::size_t>(std::distance(graph.regions.begin(),
+				std::find(graph.regions.begin(), graph.regions.end(), region)));
+		assert(index < counters.size());
+		if (!counters[index])
+			counters[index] = &make<event_counter>(region, graph.tokens_received);
+		return *counters[index];
+	}
+
+	void chain()
+	{
+		auto& generator = make<event_generator>(block_region(0));
+		auto* previous = &generator.out();
+		for (std::size_t i = 1; i + 1 < planned_nodes; ++i)
+		{
+			auto& terminal = make_named<terminal_t>(block_region(i));
+			*previous >> terminal.in();
+			previous = &terminal.out();
+		}
+		*previous >> counter(block_region(planned_nodes - 1)).in();
+	}
+
+	void fan_out()
+	{
+		constexpr std::size_t fan = 4;
+		auto& generator = make<event_generator>(block_region(0));
+		std::deque<event_source<int>*> open{&generator.out()};
+		std::size_t created = 1;
+		while (created < planned_nodes)
+		{
+			auto* parent = open.front();
+			open.pop_front();
+			for (std::size_t i = 0; i < fan && created < planned_nodes; ++i, ++created)
+			{
+				auto& terminal = make_named<terminal_t>(block_region(created));
+				*parent >> terminal.in();
+				open.push_back(&terminal.out());
+			}
+		}
+		// all leaves are counted in the last region.
+		for (auto* leaf : open)
+			*leaf >> counter(graph.regions.back()).in();
+	}
+
+	void diamond()
+	{
+		// generator, hold_last, width branches, width - 1 merges with terminals and puller.
+		const auto width = std::max<std::size_t>(2, planned_nodes / 3);
+		std::size_t created = 0;
+		const auto next_region = [&]() { return block_region(created++ * planned_nodes
+				/ (3 * width + 1)); };
+
+		auto& generator = make<event_generator>(next_region());
+		auto& hold = make<hold_last<int, tree_base_node>>(next_region(), 0);
+		generator.out() >> hold.in();
+
+		std::deque<state_source<int>*> open;
+		for (std::size_t i = 0; i < width; ++i)
+		{
+			auto& branch = make_named<state_terminal<int>>(next_region());
+			hold.out() >> branch.in();
+			open.push_back(&branch.out());
+		}
+		while (open.size() > 1)
+		{
+			const auto& region = next_region();
+			auto& merge = make_named<merge_t>(region, add{});
+			*open[0] >> merge.in<0>();
+			*open[1] >> merge.in<1>();
+			open.pop_front();
+			open.pop_front();
+			auto& joined = make_named<state_terminal<int>>(region);
+			[&merge]() { return merge(); } >> joined.in();
+			open.push_back(&joined.out());
+		}
+		auto& puller = make<state_puller>(graph.regions.back(), graph.tokens_received);
+		*open.front() >> puller.in();
+	}
+
+	void random_dag()
+	{
+		auto& generator = make<event_generator>(random_region());
+		std::vector<std::pair<event_source<int>*, bool>> sources{{&generator.out(), false}};
+		const auto nr_of_terminals = planned_nodes > graph.regions.size() + 1
+				? planned_nodes - graph.regions.size() - 1 : 1;
+		for (std::size_t i = 0; i < nr_of_terminals; ++i)
+		{
+			auto& predecessor = sources[random_index(sources.size())];
+			auto& terminal = make_named<terminal_t>(random_region());
+			*predecessor.first >> terminal.in();
+			predecessor.second = true;
+			sources.emplace_back(&terminal.out(), false);
+		}
+		for (auto& source : sources)
+		{
+			// leaves always end in a sink, other nodes with probability 1/2.
+			if (!source.second || random_index(2) == 0)
+				*source.first >> counter(random_region()).in();
+		}
+	}
+
+private:
+	synthetic_graph& graph;
+	const std::size_t planned_nodes;
+	std::mt19937 random;
+	std::vector<event_counter*> counters;
+};
+}
+
+std::unique_ptr<synthetic_graph> make_graph(topology shape, std::size_t nr_of_nodes,
+		std::size_t nr_of_regions, std::uint32_t seed)
+{
+	assert(nr_of_nodes > 0);
+	assert(nr_of_regions > 0);
+	auto graph = std::make_unique<synthetic_graph>();
+	for (std::size_t i = 0; i < nr_of_regions; ++i)
+		graph->regions.push_back(graph->infra.add_region("region" + std::to_string(i),
+				thread::cycle_control::fast_tick));
+
+	graph_builder builder{*graph, std::max<std::size_t>(nr_of_nodes, 2), seed};
+	switch (shape)
+	{
+	case topology::chain: builder.chain(); break;
+	case topology::fan_out: builder.fan_out(); break;
+	case topology::diamond: builder.diamond(); break;
+	case topology::random_dag: builder.random_dag(); break;
+	}
+	return graph;
+}
+
+}
+}
@@ -0,0 +1,62 @@
+#ifndef BENCHMARKS_GRAPH_GENERATOR_H_
+#define BENCHMARKS_GRAPH_GENERATOR_H_
+
+#include <flexcore/infrastructure.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace fc
+{
+namespace bench
+{
+
+/// shapes of synthetic graphs created by make_graph.
+enum class topology
+{
+	/// event generator followed by a chain of event_terminals.
+	chain,
+	/// event generator followed by a tree of event_terminals with fan out of four.
+	fan_out,
+	/// state fanned out to parallel state_terminals and joined again by a tree of merge_nodes.
+	diamond,
+	/**
+	 * random recursive tree of event_terminals, every terminal receives events from a random
+	 * earlier one. Additional random edges connect terminals to shared counting sinks.
+	 * Every node thus receives each event of a cycle exactly once,
+	 * event counts do not explode with the number of paths.
+	 */
+	random_dag
+};
+
+/**
+ * \brief Synthetic graph of flexcore nodes spread over several regions.
+ *
+ * The graph is built in an infrastructure, which is not started.
+ * Nodes are assigned to regions in contiguous blocks, random_dag assigns them randomly.
+ * Connections between nodes of different regions thus get buffers,
+ * just like in real applications.
+ */
+struct synthetic_graph
+{
+	infrastructure infra;
+	std::vector<std::shared_ptr<parallel_region>> regions;
+	std::size_t nr_of_nodes = 0;
+	/// tokens which reached sinks of the graph, used to check the graph actually does work.
+	std::uint64_t tokens_received = 0;
+};
+
+/**
+ * \brief creates a graph of roughly nr_of_nodes nodes with nr_of_regions regions.
+ * All regions run with fast_tick.
+ * \pre nr_of_nodes > 0, nr_of_regions > 0
+ */
+std::unique_ptr<synthetic_graph> make_graph(topology shape, std::size_t nr_of_nodes,
+		std::size_t nr_of_regions, std::uint32_t seed = 42);
+
+}
+}
+
+#endif /* BENCHMARKS_GRAPH_GENERATOR_H_ */
@@ -0,0 +1,110 @@
+#include <benchmark/benchmark.h>
+
+#include <flexcore/scheduler/cyclecontrol.hpp>
+#include <flexcore/scheduler/parallelscheduler.hpp>
+
+#include "allocation_counter.h"
+#include "graph_generator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+namespace fc
+{
+namespace bench
+{
+
+// Macro benchmark of complete synthetic graphs at application scale.
+// Every benchmark is parameterized by the number of nodes (range(0))
+// and the number of regions (range(1)). Regions are run on a parallel_scheduler
+// by an afap_main_loop, one benchmark iteration is one cycle.
+//
+// Reported counters:
+// startup_ms    time to build the graph and connect it to the scheduler
+// bytes_per_node  heap memory in use after building divided by the number of nodes
+// cycle_us      mean wall time of a cycle
+// jitter_us     standard deviation of the cycle time
+// p99_us, max_us  99th percentile and maximum of the cycle time
+
+namespace
+{
+bool ignore_timeout(thread::periodic_task&) { return true; }
+
+template <topology shape>
+void run_graph(benchmark::State& state)
+{
+	using clock = std::chrono::steady_clock;
+	using micro = std::chrono::duration<double, std::micro>;
+
+	const auto memory_before = heap_bytes_in_use();
+	const auto build_start = clock::now();
+	auto graph = make_graph(shape, static_cast<std::size_t>(state.range(0)),
+			static_cast<std::size_t>(state.range(1)));
+	auto loop = std::make_shared<thread::afap_main_loop>();
+	thread::cycle_control control{std::make_unique<thread::parallel_scheduler>(),
+			&ignore_timeout, loop};
+	for (auto& region : graph->regions)
+		control.add_task(thread::periodic_task{region}, thread::cycle_control::fast_tick);
+	const auto startup = clock::now() - build_start;
+	const auto memory = heap_bytes_in_use() - memory_before;
+
+	const std::function<void(void)> work = [&control](){ control.work(); };
+	std::vector<double> cycles;
+	cycles.reserve(100000);
+	loop->arm();
+	auto cycle_start = clock::now();
+	while (state.KeepRunning())
+	{
+		loop->loop_body(work);
+		const auto cycle_end = clock::now();
+		cycles.push_back(micro(cycle_end - cycle_start).count());
+		cycle_start = cycle_end;
+	}
+	loop->wait_for_current_tasks();
+
+	const double n = static_cast<double>(cycles.size());
+	const double mean = std::accumulate(cycles.begin(), cycles.end(), 0.0) / n;
+	const double variance = std::accumulate(cycles.begin(), cycles.end(), 0.0,
+			[mean](double sum, double c) { return sum + (c - mean) * (c - mean); }) / n;
+	std::sort(cycles.begin(), cycles.end());
+
+	state.SetItemsProcessed(state.iterations() * graph->nr_of_nodes);
+	state.counters["nodes"] = static_cast<double>(graph->nr_of_nodes);
+	state.counters["startup_ms"] = std::chrono::duration<double, std::milli>(startup).count();
+	state.counters["bytes_per_node"] = static_cast<double>(memory)
+			/ static_cast<double>(graph->nr_of_nodes);
+	state.counters["cycle_us"] = mean;
+	state.counters["jitter_us"] = std::sqrt(variance);
+	state.counters["p99_us"] = cycles[static_cast<std::size_t>(0.99 * (n - 1))];
+	state.counters["max_us"] = cycles.back();
+	state.counters["tokens_per_cycle"] = static_cast<double>(graph->tokens_received) / n;
+}
+
+void graph_sizes(benchmark::internal::Benchmark* b)
+{
+	for (long nodes : {100, 1000, 10000})
+		for (long regions : {1, 10, 40})
+			b->Args({nodes, regions});
+	b->UseRealTime();
+	b->Unit(benchmark::kMicrosecond);
+}
+}
+
+void chain_graph(benchmark::State& state) { run_graph<topology::chain>(state); }
+void fan_out_graph(benchmark::State& state) { run_graph<topology::fan_out>(state); }
+void diamond_graph(benchmark::State& state) { run_graph<topology::diamond>(state); }
+void random_dag_graph(benchmark::State& state) { run_graph<topology::random_dag>(state); }
+
+BENCHMARK(chain_graph)->Apply(graph_sizes);
+BENCHMARK(fan_out_graph)->Apply(graph_sizes);
+BENCHMARK(diamond_graph)->Apply(graph_sizes);
+BENCHMARK(random_dag_graph)->Apply(graph_sizes);
+
+}
+}
+
+BENCHMARK_MAIN();
@@ -2,6 +2,12 @@
 
 #include <flexcore/core/connection.hpp>
 #include <flexcore/core/connectables.hpp>
+#include <flexcore/extended/ports/node_aware.hpp>
+#include <flexcore/pure/event_sinks.hpp>
+#include <flexcore/pure/event_sources.hpp>
+#include <flexcore/pure/state_sink.hpp>
+#include <flexcore/pure/state_sources.hpp>
+#include <flexcore/scheduler/cyclecontrol.hpp>
 
 #include "benchmarkfunctions.h"
 
@@ -102,11 +108,100 @@ void extended_node(benchmark::State& state) {
 }
 
 
+void pure_event_connection(benchmark::State& state) {
+	std::random_device rd;
+	std::mt19937 gen(rd());
+
+	float x = gen();
+	float a = 0.0;
+
+	pure::event_source<float> source;
+	pure::event_sink<float> sink{[&a](float in){ a = in; }};
+	source >> sink;
+
+	while (state.KeepRunning()) {
+		benchmark::DoNotOptimize(x);
+
+		source.fire(x);
+
+		assert(a == x);
+		benchmark::DoNotOptimize(a);
+	}
+}
+
+/// connection between node_aware ports of the same region, needs no buffer.
+void node_aware_event_connection(benchmark::State& state) {
+	std::random_device rd;
+	std::mt19937 gen(rd());
+
+	float x = gen();
+	float a = 0.0;
+
+	parallel_region region{"region", thread::cycle_control::fast_tick};
+	node_aware<pure::event_source<float>> source{region};
+	node_aware<pure::event_sink<float>> sink{region, [&a](float in){ a = in; }};
+	source >> sink;
+
+	while (state.KeepRunning()) {
+		benchmark::DoNotOptimize(x);
+
+		source.fire(x);
+
+		assert(a == x);
+		benchmark::DoNotOptimize(a);
+	}
+}
+
+void pure_state_connection(benchmark::State& state) {
+	std::random_device rd;
+	std::mt19937 gen(rd());
+
+	float x = gen();
+
+	pure::state_source<float> source{[&x](){ return x; }};
+	pure::state_sink<float> sink;
+	source >> sink;
+
+	while (state.KeepRunning()) {
+		benchmark::DoNotOptimize(x);
+
+		const float a = sink.get();
+
+		assert(a == x);
+		benchmark::DoNotOptimize(a);
+	}
+}
+
+/// state connection between node_aware ports of the same region, needs no buffer.
+void node_aware_state_connection(benchmark::State& state) {
+	std::random_device rd;
+	std::mt19937 gen(rd());
+
+	float x = gen();
+
+	parallel_region region{"region", thread::cycle_control::fast_tick};
+	node_aware<pure::state_source<float>> source{region, [&x](){ return x; }};
+	node_aware<pure::state_sink<float>> sink{region};
+	source >> sink;
+
+	while (state.KeepRunning()) {
+		benchmark::DoNotOptimize(x);
+
+		const float a = sink.get();
+
+		assert(a == x);
+		benchmark::DoNotOptimize(a);
+	}
+}
 
 BENCHMARK(lambda);
 BENCHMARK(virtual_function);
 BENCHMARK(pure_port);
 BENCHMARK(extended_node);
+BENCHMARK(pure_event_connection);
+BENCHMARK(node_aware_event_connection);
+BENCHMARK(pure_state_connection);
+BENCHMARK(node_aware_state_connection);
 
 }
 }
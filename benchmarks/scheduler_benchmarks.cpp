@@ -0,0 +1,213 @@
+#include <benchmark/benchmark.h>
+
+#include <flexcore/scheduler/cyclecontrol.hpp>
+#include <flexcore/scheduler/parallelscheduler.hpp>
+#include <flexcore/scheduler/serialschedulers.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace fc
+{
+namespace bench
+{
+
+// Benchmarks of the scheduler, which limits how flexcore scales with regions and threads.
+
+namespace
+{
+/// number of tasks added to the scheduler per benchmark iteration.
+constexpr int tasks_per_batch = 1000;
+
+/// busy work of a region in a loaded graph, roughly size floating point operations.
+void simulated_work(int size)
+{
+	float x = 1.0f;
+	for (int i = 0; i < size; ++i)
+		x = x * 1.0001f + 0.5f;
+	benchmark::DoNotOptimize(x);
+}
+
+/**
+ * Creates tasks periodic tasks without region and regions periodic tasks with regions,
+ * each region does region_work operations on its work tick.
+ */
+void add_fast_tasks(thread::cycle_control& control, int tasks, int regions, int region_work,
+		std::vector<std::shared_ptr<parallel_region>>& region_storage)
+{
+	for (int i = 0; i < tasks; ++i)
+		control.add_task(thread::periodic_task{[](){}}, thread::cycle_control::fast_tick);
+	for (int i = 0; i < regions; ++i)
+	{
+		auto region = std::make_shared<parallel_region>(
+				"region" + std::to_string(i), thread::cycle_control::fast_tick);
+		region->ticks.work_tick() >> [region_work](){ simulated_work(region_work); };
+		control.add_task(thread::periodic_task{region}, thread::cycle_control::fast_tick);
+		region_storage.push_back(std::move(region));
+	}
+}
+
+/// do not abort benchmarks on slow tasks, afap loops wait for them anyway.
+bool ignore_timeout(thread::periodic_task&) { return true; }
+}
+
+/**
+ * Throughput of parallel_scheduler::add_task for range(0) worker threads.
+ * Every iteration adds a batch of empty tasks and waits until all are executed.
+ */
+void parallel_scheduler_add_task(benchmark::State& state)
+{
+	thread::parallel_scheduler scheduler{static_cast<int>(state.range(0))};
+	std::atomic<int> executed{0};
+
+	while (state.KeepRunning())
+	{
+		executed.store(0, std::memory_order_relaxed);
+		for (int i = 0; i < tasks_per_batch; ++i)
+			scheduler.add_task([&executed](){ executed.fetch_add(1, std::memory_order_relaxed); });
+		while (executed.load(std::memory_order_relaxed) != tasks_per_batch)
+			std::this_thread::yield();
+	}
+	state.SetItemsProcessed(state.iterations() * tasks_per_batch);
+}
+BENCHMARK(parallel_scheduler_add_task)->RangeMultiplier(2)->Range(1, 16)->UseRealTime();
+
+/**
+ * Latency of a fast tick task, which is added after range(0) long slow tick tasks
+ * to a parallel_scheduler with two worker threads.
+ * The latency is the time from adding the fast task until it starts,
+ * reported as mean in microseconds.
+ */
+void parallel_scheduler_fast_latency(benchmark::State& state)
+{
+	using clock = wall_clock::steady;
+	thread::parallel_scheduler scheduler{2};
+	std::atomic<int> executed{0};
+	clock::duration latency{};
+	const auto slow_tasks = static_cast<int>(state.range(0));
+
+	while (state.KeepRunning())
+	{
+		executed.store(0);
+		for (int i = 0; i < slow_tasks; ++i)
+			scheduler.add_task([&executed]()
+					{
+						simulated_work(100000);
+						++executed;
+					}, thread::cycle_control::slow_tick);
+		const auto added = clock::now();
+		scheduler.add_task([&executed, &latency, added]()
+				{
+					latency += clock::now() - added;
+					++executed;
+				}, thread::cycle_control::fast_tick);
+		while (executed.load() != slow_tasks + 1)
+			std::this_thread::yield();
+	}
+	state.counters["fast_latency_us"] =
+			std::chrono::duration<double, std::micro>(latency).count() / state.iterations();
+}
+BENCHMARK(parallel_scheduler_fast_latency)->Arg(2)->Arg(8)->Arg(32)->UseRealTime();
+
+/**
+ * Overhead of cycle_control::work for range(0) periodic tasks and range(1) regions.
+ * The blocking_scheduler executes all tasks immediately,
+ * so only the bookkeeping of cycle_control is measured.
+ */
+void cycle_control_work(benchmark::State& state)
+{
+	thread::cycle_control control{std::make_unique<thread::blocking_scheduler>(),
+			&ignore_timeout, std::make_shared<thread::afap_main_loop>()};
+	std::vector<std::shared_ptr<parallel_region>> regions;
+	add_fast_tasks(control, static_cast<int>(state.range(0)),
+			static_cast<int>(state.range(1)), 0, regions);
+
+	while (state.KeepRunning())
+		control.work();
+
+	state.SetItemsProcessed(state.iterations() * (state.range(0) + state.range(1)));
+}
+BENCHMARK(cycle_control_work)
+		->Args({1, 0})->Args({10, 0})->Args({100, 0})->Args({1000, 0})
+		->Args({0, 1})->Args({0, 10})->Args({0, 100})->Args({0, 1000});
+
+/**
+ * Ticks per second of the afap_main_loop with range(0) regions,
+ * each doing range(1) operations per tick, on a parallel_scheduler.
+ * One benchmark iteration is one tick, thus items per second are ticks per second.
+ */
+void afap_main_loop_ticks(benchmark::State& state)
+{
+	auto loop = std::make_shared<thread::afap_main_loop>();
+	thread::cycle_control control{std::make_unique<thread::parallel_scheduler>(),
+			&ignore_timeout, loop};
+	std::vector<std::shared_ptr<parallel_region>> regions;
+	add_fast_tasks(control, 0, static_cast<int>(state.range(0)),
+			static_cast<int>(state.range(1)), regions);
+
+	const std::function<void(void)> work = [&control](){ control.work(); };
+	loop->arm();
+	// this is the body of the main loop thread started by cycle_control::start.
+	while (state.KeepRunning())
+		loop->loop_body(work);
+	loop->wait_for_current_tasks();
+
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(afap_main_loop_ticks)
+		->Args({0, 0})->Args({1, 0})->Args({10, 0})->Args({100, 0})
+		->Args({1, 10000})->Args({10, 10000})->Args({100, 10000})
+		->UseRealTime();
+
+/**
+ * Wake-up jitter of realtime main loops.
+ * One benchmark iteration is one tick of cycle_control::min_tick_length.
+ * The error of a tick is the time its work started later than the end of the previous tick,
+ * reported as mean and max in microseconds.
+ * Run with --benchmark_min_time to measure enough ticks for a meaningful maximum.
+ */
+template <class loop_t>
+void main_loop_wakeup_error(benchmark::State& state, std::shared_ptr<loop_t> loop)
+{
+	using clock = wall_clock::steady;
+	clock::time_point deadline{};
+	clock::duration sum{};
+	clock::duration max{};
+	long measured = 0;
+	const std::function<void(void)> work = [&]()
+	{
+		const auto now = clock::now();
+		if (deadline != clock::time_point{})
+		{
+			const auto error = now - deadline;
+			sum += error;
+			max = std::max(max, error);
+			++measured;
+		}
+		else
+			deadline = now;
+		deadline += thread::cycle_control::min_tick_length;
+	};
+
+	loop->arm();
+	while (state.KeepRunning())
+		loop->loop_body(work);
+
+	const auto to_us = [](clock::duration d)
+	{
+		return std::chrono::duration<double, std::micro>(d).count();
+	};
+	state.counters["mean_error_us"] = measured ? to_us(sum) / measured : 0.0;
+	state.counters["max_error_us"] = to_us(max);
+}
+BENCHMARK_CAPTURE(main_loop_wakeup_error, realtime_main_loop,
+		std::make_shared<thread::realtime_main_loop>())->UseRealTime();
+BENCHMARK_CAPTURE(main_loop_wakeup_error, low_jitter_main_loop,
+		std::make_shared<thread::low_jitter_main_loop>())->UseRealTime();
+
+}
+}
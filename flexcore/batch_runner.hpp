@@ -0,0 +1,127 @@
+#ifndef SRC_BATCH_RUNNER_HPP_
+#define SRC_BATCH_RUNNER_HPP_
+
+#include <flexcore/infrastructure.hpp>
+#include <flexcore/scheduler/parallelscheduler.hpp>
+#include <flexcore/scheduler/serialschedulers.hpp>
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace fc
+{
+
+/// Result and timings of a single run of a batch_runner.
+template <class result_t>
+struct batch_result
+{
+	/// index of the run within the batch
+	std::size_t index = 0;
+	/// value returned by the run, default constructed if the run threw.
+	result_t value{};
+	/// exception thrown by the run, nullptr if it succeeded.
+	std::exception_ptr error;
+	/// wall time the run took, including building its graph
+	wall_clock::steady::duration wall_time{};
+	/// virtual time the run simulated
+	virtual_clock::duration virtual_time{};
+
+	bool succeeded() const { return !error; }
+};
+
+/**
+ * \brief Runs independent simulations in parallel on a shared pool of worker threads.
+ *
+ * Every run gets its own infrastructure with its own clock_context
+ * and a blocking_scheduler, which executes its work ticks on the worker running it.
+ * Thus runs do not interfere, every run is executed as fast as possible
+ * and the batch keeps all workers of the pool busy while runs are left.
+ *
+ * \code{cpp}
+ * batch_runner runner;
+ * auto results = runner.run(parameters.size(), [&](infrastructure& infra, std::size_t i)
+ * {
+ *     auto& node = infra.node_owner().make_child<my_node>(parameters[i]);
+ *     infra.run_cycles(1000);
+ *     return node.result();
+ * });
+ * \endcode
+ */
+class batch_runner
+{
+public:
+	/// \pre nr_of_threads > 0
+	explicit batch_runner(int nr_of_threads = thread::parallel_scheduler::num_threads())
+		: pool(nr_of_threads)
+	{
+	}
+
+	/**
+	 * \brief executes nr_of_runs runs and waits for all of them.
+	 *
+	 * \param simulation called as simulation(infrastructure&, index) for every run.
+	 * Builds the graph of the run, executes it, for example with infrastructure::run_cycles,
+	 * and returns its result. Exceptions thrown by simulation are stored in the result.
+	 * \returns results ordered by index of the run.
+	 */
+	template <class simulation_t>
+	auto run(std::size_t nr_of_runs, simulation_t simulation);
+
+private:
+	thread::parallel_scheduler pool;
+};
+
+template <class simulation_t>
+auto batch_runner::run(std::size_t nr_of_runs, simulation_t simulation)
+{
+	using result_t = std::decay_t<
+			decltype(simulation(std::declval<infrastructure&>(), std::size_t{}))>;
+	static_assert(!std::is_void<result_t>{}, "runs of a batch_runner need to return a result.");
+
+	std::vector<batch_result<result_t>> results(nr_of_runs);
+	std::mutex finished_mutex;
+	std::condition_variable all_finished;
+	std::size_t finished = 0;
+
+	for (std::size_t i = 0; i != nr_of_runs; ++i)
+	{
+		pool.add_task([&, i]()
+				{
+					auto& result = results[i];
+					result.index = i;
+					const auto start = wall_clock::steady::now();
+					try
+					{
+						auto clocks = std::make_shared<clock_context>();
+						const clock_context::scope bind_clocks{*clocks};
+						infrastructure infra{clocks,
+								std::make_unique<thread::blocking_scheduler>()};
+						result.value = simulation(infra, i);
+						result.virtual_time = clocks->steady_now().time_since_epoch();
+					}
+					catch (...)
+					{
+						result.error = std::current_exception();
+					}
+					result.wall_time = wall_clock::steady::now() - start;
+
+					std::lock_guard<std::mutex> lock(finished_mutex);
+					if (++finished == nr_of_runs)
+						all_finished.notify_all();
+				});
+	}
+
+	std::unique_lock<std::mutex> lock(finished_mutex);
+	all_finished.wait(lock, [&]() { return finished == nr_of_runs; });
+	return results;
+}
+
+} // namespace fc
+
+#endif /* SRC_BATCH_RUNNER_HPP_ */
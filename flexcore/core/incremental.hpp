@@ -0,0 +1,144 @@
+#ifndef SRC_CORE_INCREMENTAL_HPP_
+#define SRC_CORE_INCREMENTAL_HPP_
+
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace fc
+{
+
+/**
+ * \brief Token of incremental state chains, an immutable value together with its version.
+ *
+ * The version changes whenever the value changes,
+ * thus stages of a chain can tell whether their input changed since the last pull
+ * without comparing values.
+ * Versions only count the changes of one value,
+ * thus tokens of different values are told apart by their payload.
+ * Copies share the value, copying a versioned token is cheap regardless of its size.
+ * \tparam T type of the value
+ * \see versioned_value, incremental
+ */
+template <class T>
+class versioned
+{
+public:
+	versioned() = default;
+	versioned(std::shared_ptr<const T> value, std::uint64_t version)
+		: value_(std::move(value)), version_(version)
+	{
+	}
+
+	/// \pre has_value()
+	const T& get() const
+	{
+		assert(value_);
+		return *value_;
+	}
+	bool has_value() const { return static_cast<bool>(value_); }
+	std::uint64_t version() const { return version_; }
+	/// shared value, all tokens of the same value and version share the same payload.
+	const std::shared_ptr<const T>& payload() const { return value_; }
+
+private:
+	std::shared_ptr<const T> value_;
+	std::uint64_t version_ = 0;
+};
+
+/**
+ * \brief Value of a node, which provides versioned tokens to incremental state chains.
+ *
+ * Every set marks the value as changed by incrementing its version.
+ * Use it as the action of a state_source to start an incremental chain:
+ * \code{cpp}
+ * versioned_value<calibration> current{calibration{}};
+ * state_source<versioned<calibration>> out{this, std::ref(current)};
+ * \endcode
+ */
+template <class T>
+class versioned_value
+{
+public:
+	explicit versioned_value(T initial)
+		: value(std::make_shared<const T>(std::move(initial)))
+	{
+	}
+
+	/// replaces the value, stages depending on it are recomputed on their next pull.
+	void set(T new_value)
+	{
+		value = std::make_shared<const T>(std::move(new_value));
+		++version_;
+	}
+
+	const T& get() const { return *value; }
+	std::uint64_t version() const { return version_; }
+
+	/// returns the current value as token.
+	versioned<T> operator()() const { return versioned<T>{value, version_}; }
+
+private:
+	std::shared_ptr<const T> value;
+	std::uint64_t version_ = 0;
+};
+
+namespace detail
+{
+template <class op_t>
+struct incremental_op
+{
+	template <class in_t>
+	auto operator()(const versioned<in_t>& in)
+	{
+		using out_t = std::decay_t<decltype(op(in.get()))>;
+		if (!cache || in.payload() != input || in.version() != input_version)
+		{
+			cache = std::make_shared<const out_t>(op(in.get()));
+			input = in.payload();
+			input_version = in.version();
+			++output_version;
+		}
+		return versioned<out_t>{std::static_pointer_cast<const out_t>(cache), output_version};
+	}
+
+	op_t op;
+	/// output of the last computation, type erased as the input type is only known on the call.
+	std::shared_ptr<const void> cache{};
+	/**
+	 * payload of the input of the last computation.
+	 * Held to keep its address from being reused by a new payload, which would hit the cache.
+	 */
+	std::shared_ptr<const void> input{};
+	std::uint64_t input_version = 0;
+	std::uint64_t output_version = 0;
+};
+}
+
+/**
+ * \brief Stage of an incremental state chain, which caches its last output.
+ *
+ * Takes versioned tokens and applies op to their value,
+ * but only if the version or payload of the input changed since the previous pull.
+ * Thus inputs switched between several versioned_values, for example by a mux, are recomputed.
+ * Otherwise the cached output is returned without calling op.
+ * Thus pulling a chain of incremental stages recomputes only the stages whose inputs changed.
+ * \code{cpp}
+ * source.out() >> incremental(expensive_transform) >> incremental(other_transform) >> sink.in();
+ * \endcode
+ *
+ * \param op transform with signature out_t(const in_t&) without side effects.
+ * \returns connectable from versioned<in_t> to versioned<out_t>.
+ * \pre op needs to fulfill copy_constructible or move_constructible.
+ */
+template <class op_t>
+auto incremental(op_t&& op)
+{
+	return detail::incremental_op<std::decay_t<op_t>>{std::forward<op_t>(op)};
+}
+
+} // namespace fc
+
+#endif /* SRC_CORE_INCREMENTAL_HPP_ */
@@ -0,0 +1,81 @@
+#ifndef SRC_CORE_SHARED_HPP_
+#define SRC_CORE_SHARED_HPP_
+
+#include <cassert>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace fc
+{
+
+/**
+ * \brief Token, which shares an immutable payload between all its copies.
+ *
+ * Events are copied for every connected handler and every buffer they pass.
+ * Copies of shared only copy a reference counted pointer, not the payload.
+ * Thus large payloads like frames are delivered to any number of sinks
+ * and across regions without copying them.
+ * shared converts implicitly to const T&, thus handlers can take either.
+ * \code{cpp}
+ * event_source<shared<frame>> out;
+ * out >> [](const frame& f) { process(f); };
+ * out.fire(share(std::move(new_frame)));
+ * \endcode
+ *
+ * shared is also the snapshot handle of large states.
+ * State ports return their state by value,
+ * a state_source<shared<T>> hands out the same payload to all pulls and across regions
+ * instead of copying the state for every sink and state_buffer.
+ * The payload lives as long as any handle to it, independent of ticks.
+ * Keep the handle while using the state, a const T& bound to a temporary handle dangles:
+ * \code{cpp}
+ * const auto snapshot = in.get(); // valid until snapshot is destroyed
+ * const frame& f = in.get(); // dangling, the temporary handle is destroyed immediately
+ * \endcode
+ * \tparam T type of the payload, the payload can not be changed after construction.
+ */
+template <class T>
+class shared
+{
+public:
+	static_assert(!std::is_reference<T>{}, "payload of shared needs to be a value type.");
+
+	/// constructs shared without payload. \post !has_value()
+	shared() = default;
+	/// takes ownership of value as payload.
+	explicit shared(T value) : payload(std::make_shared<const T>(std::move(value))) {}
+	/// \pre payload != nullptr
+	explicit shared(std::shared_ptr<const T> payload) : payload(std::move(payload))
+	{
+		assert(this->payload);
+	}
+
+	/// \pre has_value()
+	const T& get() const
+	{
+		assert(payload);
+		return *payload;
+	}
+	const T& operator*() const { return get(); }
+	const T* operator->() const { return &get(); }
+	operator const T&() const { return get(); }
+
+	bool has_value() const { return static_cast<bool>(payload); }
+	/// returns the number of tokens sharing the payload.
+	long use_count() const { return payload.use_count(); }
+
+private:
+	std::shared_ptr<const T> payload;
+};
+
+/// moves value into the payload of a new shared token.
+template <class T>
+shared<std::decay_t<T>> share(T&& value)
+{
+	return shared<std::decay_t<T>>{std::forward<T>(value)};
+}
+
+} // namespace fc
+
+#endif /* SRC_CORE_SHARED_HPP_ */
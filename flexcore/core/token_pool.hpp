@@ -0,0 +1,116 @@
+#ifndef SRC_CORE_TOKEN_POOL_HPP_
+#define SRC_CORE_TOKEN_POOL_HPP_
+
+#include <flexcore/core/shared.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace fc
+{
+
+/**
+ * \brief Recycles the payloads of shared tokens.
+ *
+ * A payload returns to the pool, once the last token referencing it was released,
+ * by the last sink or buffer which received it.
+ * New payloads are only created, if all payloads of the pool are in use.
+ * Thus a pipeline, which sends a steady number of tokens per tick,
+ * does not allocate memory for payloads after its first ticks.
+ * \code{cpp}
+ * token_pool<frame> frames{[]() { return frame(width, height); }};
+ * out.fire(frames.make([&](frame& f) { camera.capture(f); }));
+ * \endcode
+ * The pool is thread safe, tokens may be released in any region.
+ * \tparam T type of payload
+ */
+template <class T>
+class token_pool
+{
+public:
+	/// \param make_payload creates new payloads, when all payloads are in use.
+	explicit token_pool(std::function<T(void)> make_payload = []() { return T{}; })
+		: make_payload(std::move(make_payload))
+	{
+	}
+
+	token_pool(const token_pool&) = delete;
+	token_pool& operator=(const token_pool&) = delete;
+
+	/**
+	 * \brief fills a free payload and returns it as shared token.
+	 *
+	 * \param fill called with the payload, which still contains the data of its previous use.
+	 * \returns token referencing the payload, it returns to the pool once all its copies are gone.
+	 */
+	template <class fill_t>
+	shared<T> make(fill_t&& fill)
+	{
+		auto payload = acquire();
+		std::forward<fill_t>(fill)(*payload);
+		return shared<T>{std::shared_ptr<const T>{std::move(payload)}};
+	}
+
+	/// creates payloads until the pool holds at least nr_of_payloads.
+	void reserve(std::size_t nr_of_payloads)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		while (payloads.size() < nr_of_payloads)
+			payloads.push_back(std::make_shared<T>(make_payload()));
+	}
+
+	/// returns the number of payloads owned by the pool, in use or not.
+	std::size_t size() const
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return payloads.size();
+	}
+
+	/// returns the number of payloads not referenced by any token.
+	std::size_t nr_of_free_payloads() const
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		std::size_t result = 0;
+		for (const auto& payload : payloads)
+			if (payload.use_count() == 1)
+				++result;
+		return result;
+	}
+
+private:
+	/// returns a payload only referenced by the pool, creates a new one if there is none.
+	std::shared_ptr<T> acquire()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		// search starts after the payload acquired last, as that is most likely still in use.
+		for (std::size_t i = 0; i != payloads.size(); ++i)
+		{
+			next = (next + 1) % payloads.size();
+			if (payloads[next].use_count() == 1)
+			{
+				// pairs with the release of the last token, which wrote the payload.
+				std::atomic_thread_fence(std::memory_order_acquire);
+				return payloads[next];
+			}
+		}
+		payloads.push_back(std::make_shared<T>(make_payload()));
+		next = payloads.size() - 1;
+		return payloads.back();
+	}
+
+	std::function<T(void)> make_payload;
+	mutable std::mutex mutex;
+	/// all payloads of the pool, free payloads are only referenced from here.
+	std::vector<std::shared_ptr<T>> payloads;
+	/// index of the payload acquired last.
+	std::size_t next = 0;
+};
+
+} // namespace fc
+
+#endif /* SRC_CORE_TOKEN_POOL_HPP_ */
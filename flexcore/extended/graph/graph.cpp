@@ -6,6 +6,7 @@
 #include <boost/uuid/uuid_generators.hpp>
 
 #include <mutex>
+#include <utility>
 
 namespace fc
 {
@@ -48,6 +49,7 @@ struct connection_graph::impl
 	std::map<graph::unique_id, dataflow_graph_t::vertex_descriptor> vertex_map;
 	std::unordered_set<graph_edge> edge_set;
 	std::set<graph_properties> port_set;
+	port_statistics statistics;
 
 	mutable std::mutex graph_mutex;
 };
@@ -188,5 +190,62 @@ void connection_graph::clear_graph()
 	graph.clear();
 }
 
+port_statistics& connection_graph::statistics()
+{
+	return pimpl->statistics;
+}
+
+const port_statistics& connection_graph::statistics() const
+{
+	return pimpl->statistics;
+}
+
+std::vector<std::set<unique_id>> independent_subgraphs(
+		const connection_graph& graph, const parallel_region& region)
+{
+	// union find over all nodes, the root of every node is the smallest id of its subgraph.
+	std::map<unique_id, unique_id> parent;
+	const auto find = [&parent](unique_id node)
+	{
+		auto root = parent.emplace(node, node).first->second;
+		while (!(parent[root] == root))
+			root = parent[root];
+		parent[node] = root;
+		return root;
+	};
+
+	for (const auto& edge : graph.edges())
+	{
+		const auto source_region = edge.source.node_properties.region();
+		const auto sink_region = edge.sink.node_properties.region();
+		if (source_region && sink_region && source_region != sink_region)
+			continue;
+		const auto source_root = find(edge.source.node_properties.get_id());
+		const auto sink_root = find(edge.sink.node_properties.get_id());
+		if (source_root < sink_root)
+			parent[sink_root] = source_root;
+		else
+			parent[source_root] = sink_root;
+	}
+
+	std::set<unique_id> region_nodes;
+	for (const auto& port : graph.ports())
+		if (port.node_properties.region() == &region)
+			region_nodes.insert(port.node_properties.get_id());
+	for (const auto& edge : graph.edges())
+		for (const auto& end : {edge.source, edge.sink})
+			if (end.node_properties.region() == &region)
+				region_nodes.insert(end.node_properties.get_id());
+
+	std::map<unique_id, std::set<unique_id>> subgraphs;
+	for (const auto& node : region_nodes)
+		subgraphs[find(node)].insert(node);
+
+	std::vector<std::set<unique_id>> result;
+	for (auto& subgraph : subgraphs)
+		result.push_back(std::move(subgraph.second));
+	return result;
+}
+
 } // namespace graph
 } // namespace fc
@@ -2,6 +2,7 @@
 #define SRC_GRAPH_GRAPH_HPP_
 
 #include <flexcore/core/traits.hpp>
+#include <flexcore/extended/graph/port_statistics.hpp>
 
 #include <boost/functional/hash.hpp>
 #include <boost/uuid/uuid.hpp>
@@ -9,6 +10,7 @@
 #include <map>
 #include <set>
 #include <unordered_set>
+#include <vector>
 
 namespace fc
 {
@@ -154,6 +156,10 @@ public:
 	/// deleted the current graph \post graph is empty
 	void clear_graph();
 
+	/// Counters of tokens of the ports in this graph, keyed by graph_port_properties::id.
+	port_statistics& statistics();
+	const port_statistics& statistics() const;
+
 	~connection_graph();
 
 private:
@@ -161,6 +167,20 @@ private:
 	std::unique_ptr<impl> pimpl;
 };
 
+/**
+ * \brief finds the independent subgraphs of the nodes of a region.
+ *
+ * Nodes of the region are in the same subgraph, if they are connected,
+ * either directly or through nodes without region, like named lambdas.
+ * Connections to nodes of other regions are buffered and do not join subgraphs.
+ * Work of nodes in different subgraphs can be executed in parallel,
+ * see tick_controller::parallel_work_tick.
+ * Only nodes with ports registered in graph are considered.
+ * \returns ids of the nodes of every subgraph, ordered by the smallest id of each subgraph.
+ */
+std::vector<std::set<unique_id>> independent_subgraphs(
+		const connection_graph& graph, const parallel_region& region);
+
 } // namespace graph
 } // namespace fc
 
@@ -0,0 +1,66 @@
+#include <flexcore/extended/graph/port_statistics.hpp>
+
+#include <cassert>
+
+namespace fc
+{
+namespace graph
+{
+
+namespace
+{
+port_counts snapshot(const port_counters& c)
+{
+	port_counts result;
+	result.fired = c.fired.load(std::memory_order_relaxed);
+	result.pulled = c.pulled.load(std::memory_order_relaxed);
+	result.buffered = c.buffered.load(std::memory_order_relaxed);
+	result.bytes = c.bytes.load(std::memory_order_relaxed);
+	result.handler_time = std::chrono::nanoseconds(c.handler_ns.load(std::memory_order_relaxed));
+	return result;
+}
+}
+
+std::shared_ptr<port_counters> port_statistics::register_port(const port_id& id)
+{
+	std::lock_guard<std::mutex> lock(registry_mutex);
+	auto& entry = counters[id];
+	if (!entry)
+		entry = std::make_shared<port_counters>();
+	assert(entry);
+	return entry;
+}
+
+port_counts port_statistics::counts(const port_id& id) const
+{
+	std::lock_guard<std::mutex> lock(registry_mutex);
+	const auto it = counters.find(id);
+	if (it == counters.end())
+		return port_counts{};
+	return snapshot(*it->second);
+}
+
+std::map<port_statistics::port_id, port_counts> port_statistics::all_counts() const
+{
+	std::lock_guard<std::mutex> lock(registry_mutex);
+	std::map<port_id, port_counts> result;
+	for (const auto& entry : counters)
+		result.emplace(entry.first, snapshot(*entry.second));
+	return result;
+}
+
+void port_statistics::reset()
+{
+	std::lock_guard<std::mutex> lock(registry_mutex);
+	for (auto& entry : counters)
+	{
+		entry.second->fired.store(0, std::memory_order_relaxed);
+		entry.second->pulled.store(0, std::memory_order_relaxed);
+		entry.second->buffered.store(0, std::memory_order_relaxed);
+		entry.second->bytes.store(0, std::memory_order_relaxed);
+		entry.second->handler_ns.store(0, std::memory_order_relaxed);
+	}
+}
+
+} // namespace graph
+} // namespace fc
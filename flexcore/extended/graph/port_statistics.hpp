@@ -0,0 +1,82 @@
+#ifndef SRC_GRAPH_PORT_STATISTICS_HPP_
+#define SRC_GRAPH_PORT_STATISTICS_HPP_
+
+#include <boost/uuid/uuid.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace fc
+{
+namespace graph
+{
+
+/**
+ * \brief Counters of tokens passing through a single port.
+ *
+ * Counters are updated with relaxed atomics from whatever thread uses the port.
+ * They are only filled if flexcore is built with FLEXCORE_ENABLE_PORT_STATISTICS.
+ */
+struct port_counters
+{
+	/// events sent by an event_source or received by an event_sink.
+	std::atomic<std::uint64_t> fired{0};
+	/// states pulled by a state_sink or provided by a state_source.
+	std::atomic<std::uint64_t> pulled{0};
+	/// tokens which passed a buffer between regions.
+	std::atomic<std::uint64_t> buffered{0};
+	/// bytes of fired and pulled tokens, only counted for types with known size.
+	std::atomic<std::uint64_t> bytes{0};
+	/// time spent in handlers of event_sinks and in state_sources in nanoseconds.
+	std::atomic<std::uint64_t> handler_ns{0};
+};
+
+/// Snapshot of port_counters at the time of the query.
+struct port_counts
+{
+	std::uint64_t fired = 0;
+	std::uint64_t pulled = 0;
+	std::uint64_t buffered = 0;
+	std::uint64_t bytes = 0;
+	std::chrono::nanoseconds handler_time = std::chrono::nanoseconds::zero();
+};
+
+/**
+ * \brief Registry of port_counters keyed by the ids of graph_port_properties.
+ *
+ * Every connection_graph owns one registry, ports of nodes in the graph register there.
+ * Registering and querying is thread safe, the counters themselves are never locked.
+ */
+class port_statistics
+{
+public:
+	using port_id = boost::uuids::uuid;
+
+	/**
+	 * \brief returns counters of port with id, creates them if necessary.
+	 * \post result != nullptr
+	 */
+	std::shared_ptr<port_counters> register_port(const port_id& id);
+
+	/// returns the current counts of port with id, all zero if port is not registered.
+	port_counts counts(const port_id& id) const;
+
+	/// returns the current counts of all registered ports.
+	std::map<port_id, port_counts> all_counts() const;
+
+	/// sets all counters to zero, ports stay registered.
+	void reset();
+
+private:
+	mutable std::mutex registry_mutex;
+	std::map<port_id, std::shared_ptr<port_counters>> counters;
+};
+
+} // namespace graph
+} // namespace fc
+
+#endif /* SRC_GRAPH_PORT_STATISTICS_HPP_ */
@@ -0,0 +1,245 @@
+#ifndef FLEXCORE_EXTENDED_NODES_BRIDGE_HPP_
+#define FLEXCORE_EXTENDED_NODES_BRIDGE_HPP_
+
+#include <flexcore/extended/nodes/region_worker_node.hpp>
+#include <flexcore/utils/net/bridge.hpp>
+#include <flexcore/utils/serialisation/deserializer.hpp>
+#include <flexcore/utils/serialisation/serializer.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace fc
+{
+
+/**
+ * \brief Node which sends events to an event_bridge_in in another flexcore instance.
+ *
+ * Events received at in() during a cycle of the region are serialized with archive_t
+ * and collected. On the next switch tick of the region all of them are sent
+ * as a single framed message.
+ * Sending happens in the background, if the network does not keep up
+ * the switch tick blocks once queue_capacity messages are pending.
+ *
+ * \tparam data_t type of events sent.
+ * \tparam archive_t cereal output archive used to serialize the events.
+ * \ingroup nodes
+ *
+ * example:
+ * \code{cpp}
+ * auto& out = root.make_child<event_bridge_out<int, cereal::BinaryOutputArchive>>(
+ * 		net::endpoint{net::protocol::tcp, "192.168.0.2", 4711});
+ * source >> out.in();
+ * \endcode
+ */
+template <class data_t, class archive_t>
+class event_bridge_out final : public tree_base_node
+{
+public:
+	static constexpr auto default_name = "event_bridge_out";
+
+	event_bridge_out(const net::endpoint& remote, const node_args& node)
+		: event_bridge_out(remote, net::bridge_sender::default_capacity, node)
+	{
+	}
+
+	event_bridge_out(const net::endpoint& remote, std::size_t queue_capacity,
+			const node_args& node)
+		: tree_base_node(node)
+		, sender(std::make_unique<net::bridge_sender>(remote, queue_capacity))
+		, serialize()
+		, batch()
+		, in_event(this, [this](const data_t& in) { batch.push_back(serialize(in)); })
+	{
+		region()->switch_tick() >> [this]() { send_batch(); };
+	}
+
+	/// Event sink of type data_t
+	auto& in() { return in_event; }
+
+	/// Blocks until all messages sent so far are transmitted.
+	void flush() { sender->flush(); }
+
+private:
+	void send_batch()
+	{
+		if (batch.empty())
+			return;
+		sender->send(net::encode_batch(batch));
+		batch.clear();
+	}
+
+	std::unique_ptr<net::bridge_sender> sender;
+	single_object_serializer<data_t, archive_t> serialize;
+	std::vector<std::string> batch;
+	event_sink<data_t> in_event;
+};
+
+/**
+ * \brief Node which fires events received from an event_bridge_out.
+ *
+ * Messages are received in the background.
+ * On every work tick of the region all messages received so far are deserialized
+ * and their events fired in the order they were sent.
+ *
+ * \tparam data_t type of events received.
+ * \tparam archive_t cereal input archive matching the archive of the sender.
+ * \ingroup nodes
+ */
+template <class data_t, class archive_t>
+class event_bridge_in final : public region_worker_node
+{
+public:
+	static constexpr auto default_name = "event_bridge_in";
+
+	/// \param local address to listen on, port 0 selects a free port.
+	event_bridge_in(const net::endpoint& local, const node_args& node)
+		: event_bridge_in(local, net::bridge_receiver::default_capacity, node)
+	{
+	}
+
+	event_bridge_in(const net::endpoint& local, std::size_t queue_capacity,
+			const node_args& node)
+		: region_worker_node([this]() { fire_received(); }, node)
+		, receiver(std::make_unique<net::bridge_receiver>(local, queue_capacity))
+		, deserialize()
+		, out_event(this)
+	{
+	}
+
+	/// Event source of type data_t
+	auto& out() { return out_event; }
+
+	/// the underlying receiver, e.g. to query its port or wait for messages.
+	net::bridge_receiver& connection() { return *receiver; }
+
+private:
+	void fire_received()
+	{
+		receiver->take_all([this](const std::string& message)
+				{
+					for (const auto& token : net::decode_batch(message))
+						out_event.fire(deserialize(token));
+				});
+	}
+
+	std::unique_ptr<net::bridge_receiver> receiver;
+	single_object_deserializer<data_t, archive_t> deserialize;
+	event_source<data_t> out_event;
+};
+
+/**
+ * \brief Node which sends the state at its input to a state_bridge_in.
+ *
+ * On every work tick of the region the state is pulled, serialized and sent.
+ *
+ * \tparam data_t type of state sent.
+ * \tparam archive_t cereal output archive used to serialize the state.
+ * \ingroup nodes
+ */
+template <class data_t, class archive_t>
+class state_bridge_out final : public region_worker_node
+{
+public:
+	static constexpr auto default_name = "state_bridge_out";
+
+	state_bridge_out(const net::endpoint& remote, const node_args& node)
+		: state_bridge_out(remote, net::bridge_sender::default_capacity, node)
+	{
+	}
+
+	state_bridge_out(const net::endpoint& remote, std::size_t queue_capacity,
+			const node_args& node)
+		: region_worker_node([this]() { send_state(); }, node)
+		, sender(std::make_unique<net::bridge_sender>(remote, queue_capacity))
+		, serialize()
+		, in_state(this)
+	{
+	}
+
+	/// State sink of type data_t
+	auto& in() { return in_state; }
+
+	/// Blocks until all states sent so far are transmitted.
+	void flush() { sender->flush(); }
+
+private:
+	void send_state()
+	{
+		sender->send(net::encode_batch({serialize(in_state.get())}));
+	}
+
+	std::unique_ptr<net::bridge_sender> sender;
+	single_object_serializer<data_t, archive_t> serialize;
+	state_sink<data_t> in_state;
+};
+
+/**
+ * \brief Node which provides the latest state received from a state_bridge_out.
+ *
+ * On every work tick of the region the latest received message is taken,
+ * older messages are discarded. The state is only deserialized once it is pulled.
+ * Until the first state is received, the initial value is provided.
+ *
+ * \tparam data_t type of state received.
+ * \tparam archive_t cereal input archive matching the archive of the sender.
+ * \ingroup nodes
+ */
+template <class data_t, class archive_t>
+class state_bridge_in final : public region_worker_node
+{
+public:
+	static constexpr auto default_name = "state_bridge_in";
+
+	/// \param local address to listen on, port 0 selects a free port.
+	state_bridge_in(const net::endpoint& local, const node_args& node)
+		: state_bridge_in(local, data_t{}, node)
+	{
+	}
+
+	state_bridge_in(const net::endpoint& local, const data_t& initial_value,
+			const node_args& node)
+		: region_worker_node([this]() { take_latest(); }, node)
+		, receiver(std::make_unique<net::bridge_receiver>(local))
+		, deserialize()
+		, latest()
+		, current(initial_value)
+		, out_state(this, [this]() { return get(); })
+	{
+	}
+
+	/// State source of type data_t
+	auto& out() { return out_state; }
+
+	/// the underlying receiver, e.g. to query its port or wait for messages.
+	net::bridge_receiver& connection() { return *receiver; }
+
+private:
+	void take_latest()
+	{
+		receiver->take_all([this](const std::string& message) { latest = message; });
+	}
+
+	const data_t& get()
+	{
+		if (!latest.empty())
+		{
+			const auto tokens = net::decode_batch(latest);
+			if (!tokens.empty())
+				current = deserialize(tokens.back());
+			latest.clear();
+		}
+		return current;
+	}
+
+	std::unique_ptr<net::bridge_receiver> receiver;
+	single_object_deserializer<data_t, archive_t> deserialize;
+	std::string latest;
+	data_t current;
+	state_source<data_t> out_state;
+};
+
+} // namespace fc
+
+#endif /* FLEXCORE_EXTENDED_NODES_BRIDGE_HPP_ */
@@ -1,6 +1,7 @@
 #ifndef SRC_NODES_BUFFER_HPP_
 #define SRC_NODES_BUFFER_HPP_
 
+#include <flexcore/core/shared.hpp>
 #include <flexcore/core/traits.hpp>
 
 #include <boost/circular_buffer.hpp>
@@ -224,8 +225,21 @@ public:
 	explicit hold_last(const data_t& initial_value, args_t&&... args)
 		: base_t(std::forward<args_t>(args)...)
 		, storage(initial_value)
-		, in_port{this, [this](data_t in){ storage = in; }}
+		, in_port{this, [this](data_t in)
+				{
+					storage = std::move(in);
+					snapshot_outdated = true;
+				}}
 		, out_port{this,[this](){ return storage;} }
+		, snapshot_port{this, [this]()
+				{
+					if (snapshot_outdated)
+					{
+						current_snapshot = share(storage);
+						snapshot_outdated = false;
+					}
+					return current_snapshot;
+				}}
 	{
 	}
 
@@ -233,10 +247,23 @@ public:
 	auto& in() { return in_port; }
 	/// State out port supplying data_t.
 	auto& out() { return out_port; }
+	/**
+	 * \brief State out port supplying immutable snapshots of the last event.
+	 *
+	 * Every event is copied into a snapshot at most once, when it is pulled first.
+	 * All pulls until the next event share that snapshot.
+	 * A snapshot stays valid and unchanged as long as it is held.
+	 */
+	auto& snapshot() { return snapshot_port; }
 private:
 	data_t storage;
+	/// copy of storage handed out by snapshot, made when pulled.
+	shared<data_t> current_snapshot;
+	/// true if storage changed since current_snapshot was made.
+	bool snapshot_outdated = true;
 	typename base_t::template event_sink<data_t> in_port;
 	typename base_t::template state_source<data_t> out_port;
+	typename base_t::template state_source<shared<data_t>> snapshot_port;
 };
 
 /**
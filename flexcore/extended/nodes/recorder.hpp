@@ -0,0 +1,154 @@
+#ifndef FLEXCORE_EXTENDED_NODES_RECORDER_HPP_
+#define FLEXCORE_EXTENDED_NODES_RECORDER_HPP_
+
+#include <flexcore/extended/base_node.hpp>
+#include <flexcore/scheduler/clock.hpp>
+#include <flexcore/utils/recording/token_file.hpp>
+#include <flexcore/utils/serialisation/serializer.hpp>
+
+#include <memory>
+#include <string>
+
+namespace fc
+{
+namespace recording
+{
+namespace detail
+{
+/// serializes a single token with archive_t.
+template <class data_t, class archive_t>
+struct token_serializer
+{
+	std::string operator()(const data_t& in) { return serializer(in); }
+	single_object_serializer<data_t, archive_t> serializer;
+};
+
+/// void events carry no payload, only the timestamp is recorded.
+template <class archive_t>
+struct token_serializer<void, archive_t>
+{
+	std::string operator()() { return std::string{}; }
+};
+} // namespace detail
+} // namespace recording
+
+/**
+ * \brief Node which records all events passing through it to a token file.
+ *
+ * Events received at in() are forwarded unchanged to out().
+ * Each event is serialized with archive_t and written together with the current
+ * time of virtual_clock::steady to a recording::token_file_writer.
+ * Thus the recorder can be spliced into any event connection.
+ *
+ * The file is written asynchronously, the producing region only pays for serialization.
+ *
+ * \tparam data_t type of events recorded, may be void.
+ * \tparam archive_t cereal output archive used to serialize the events.
+ * \tparam base_node base_node to either include or exclude this node from forest.
+ * \ingroup nodes
+ *
+ * example:
+ * \code{cpp}
+ * auto& rec = root.make_child<event_recorder<int, cereal::BinaryOutputArchive>>("ints.rec");
+ * source >> rec.in();
+ * rec.out() >> sink;
+ * \endcode
+ */
+template <class data_t, class archive_t, class base_node = tree_base_node>
+class event_recorder : public base_node
+{
+public:
+	static constexpr auto default_name = "event_recorder";
+
+	/**
+	 * \param file_name path of the file recorded to. Existing files are overwritten.
+	 * \param args Arguments for base node. In the default case this is:
+	 * \code {const node_args&} \endcode
+	 */
+	template <class... base_args>
+	explicit event_recorder(const std::string& file_name, base_args&&... args)
+		: base_node(std::forward<base_args>(args)...)
+		, writer(std::make_unique<recording::token_file_writer>(file_name))
+		, serialize()
+		, in_event(this,
+				//variadic lambda to also handle void events
+				[this](auto&&... in)
+				{
+					writer->append(virtual_clock::steady::now(), serialize(in...));
+					out_event.fire(std::forward<decltype(in)>(in)...);
+				})
+		, out_event(this)
+	{
+	}
+
+	/// Event sink of type data_t
+	auto& in() { return in_event; }
+	/// Event source of type data_t, fires all events received at in()
+	auto& out() { return out_event; }
+
+	/// Blocks until all events recorded so far are written to the file.
+	void flush() { writer->flush(); }
+
+private:
+	std::unique_ptr<recording::token_file_writer> writer;
+	recording::detail::token_serializer<data_t, archive_t> serialize;
+	typename base_node::template event_sink<data_t> in_event;
+	typename base_node::template event_source<data_t> out_event;
+};
+
+/**
+ * \brief Node which records all states pulled through it to a token file.
+ *
+ * Every pull at out() pulls the state at in(), records it together with the
+ * current time of virtual_clock::steady and returns it unchanged.
+ *
+ * \tparam data_t type of state recorded.
+ * \tparam archive_t cereal output archive used to serialize the states.
+ * \tparam base_node base_node to either include or exclude this node from forest.
+ * \ingroup nodes
+ */
+template <class data_t, class archive_t, class base_node = tree_base_node>
+class state_recorder : public base_node
+{
+public:
+	static constexpr auto default_name = "state_recorder";
+
+	/**
+	 * \param file_name path of the file recorded to. Existing files are overwritten.
+	 * \param args Arguments for base node. In the default case this is:
+	 * \code {const node_args&} \endcode
+	 */
+	template <class... base_args>
+	explicit state_recorder(const std::string& file_name, base_args&&... args)
+		: base_node(std::forward<base_args>(args)...)
+		, writer(std::make_unique<recording::token_file_writer>(file_name))
+		, serialize()
+		, in_state(this)
+		, out_state(this,
+				[this]()
+				{
+					auto state = in_state.get();
+					writer->append(virtual_clock::steady::now(), serialize(state));
+					return state;
+				})
+	{
+	}
+
+	/// State sink of type data_t
+	auto& in() { return in_state; }
+	/// State source of type data_t
+	auto& out() { return out_state; }
+
+	/// Blocks until all states recorded so far are written to the file.
+	void flush() { writer->flush(); }
+
+private:
+	std::unique_ptr<recording::token_file_writer> writer;
+	recording::detail::token_serializer<data_t, archive_t> serialize;
+	typename base_node::template state_sink<data_t> in_state;
+	typename base_node::template state_source<data_t> out_state;
+};
+
+} // namespace fc
+
+#endif /* FLEXCORE_EXTENDED_NODES_RECORDER_HPP_ */
@@ -12,6 +12,8 @@
 #include <flexcore/extended/base_node.hpp>
 #include <flexcore/core/connection.hpp>
 
+#include <cstddef>
+
 namespace fc
 {
 
@@ -34,6 +36,49 @@ public:
 
 };
 
+/**
+ * \brief node which executes action on the parallel work tick of a group of given region
+ *
+ * Actions of nodes in different groups may be executed in parallel on the scheduler,
+ * thus nodes of different groups must belong to independent subgraphs of the region.
+ * Extend this class for your own worker nodes.
+ * \see tick_controller::parallel_work_tick
+ * \see graph::independent_subgraphs
+ * \ingroup nodes
+ */
+class parallel_region_worker_node : public tree_base_node
+{
+public:
+	template <class action_t>
+	parallel_region_worker_node(action_t&& action, std::size_t group, const node_args& node)
+	    : tree_base_node(node)
+	{
+		region()->ticks.parallel_work_tick(group) >> std::forward<action_t>(action);
+	}
+};
+
+/**
+ * \brief node which executes action in slices on work tick of given region
+ *
+ * The action is called repeatedly on every work tick, until it returns slice_result::done.
+ * Between two calls, the scheduler executes tasks of other regions on the same thread,
+ * thus long running work in slow regions should be split in slices
+ * to not block threads for fast regions.
+ * The action has to keep its progress between calls.
+ * Extend this class for your own worker nodes.
+ * \see tick_controller::add_sliced_work
+ * \ingroup nodes
+ */
+class sliced_region_worker_node : public tree_base_node
+{
+public:
+	template <class action_t>
+	sliced_region_worker_node(action_t&& action, const node_args& node)
+	    : tree_base_node(node)
+	{
+		region()->ticks.add_sliced_work(std::forward<action_t>(action));
+	}
+};
 
 } //namespace fc
 #endif /* SRC_NODES_REGION_WORKER_NODE_HPP_ */
@@ -0,0 +1,262 @@
+#ifndef FLEXCORE_EXTENDED_NODES_REPLAY_HPP_
+#define FLEXCORE_EXTENDED_NODES_REPLAY_HPP_
+
+#include <flexcore/extended/nodes/region_worker_node.hpp>
+#include <flexcore/scheduler/clock.hpp>
+#include <flexcore/utils/recording/token_file.hpp>
+#include <flexcore/utils/serialisation/deserializer.hpp>
+
+#include <memory>
+#include <string>
+
+namespace fc
+{
+namespace recording
+{
+
+/**
+ * \brief Plays back the records of a token file in virtual time.
+ *
+ * A record is due, once virtual_clock::steady::now() has reached
+ * its timestamp shifted by the playback offset.
+ * Initially the offset is zero, thus records are due at the time they were recorded.
+ *
+ * \invariant reader != nullptr
+ */
+class playback
+{
+public:
+	explicit playback(const std::string& file_name)
+		: reader(std::make_unique<token_file_reader>(file_name))
+		, position(reader->begin())
+		, offset(virtual_clock::duration::zero())
+	{
+	}
+
+	/**
+	 * \brief calls action with every record which is due.
+	 * \param action callable taking token_file_reader::record_view.
+	 */
+	template <class action_t>
+	void play_due(action_t&& action)
+	{
+		const auto now = virtual_clock::steady::now();
+		while (!reader->at_end(position))
+		{
+			const auto record = reader->read(position);
+			if (record.timestamp + offset > now)
+				return;
+			reader->advance(position);
+			action(record);
+		}
+	}
+
+	/**
+	 * \brief Continues playback at the first record not earlier than t.
+	 *
+	 * The record at t is due immediately,
+	 * all later records keep their time difference to it.
+	 */
+	void seek(virtual_clock::steady::time_point t)
+	{
+		position = reader->seek(t);
+		offset = virtual_clock::steady::now() - t;
+	}
+
+	/// returns true if all records have been played.
+	bool done() const { return reader->at_end(position); }
+
+private:
+	std::unique_ptr<token_file_reader> reader;
+	token_file_reader::cursor position;
+	virtual_clock::duration offset;
+};
+
+namespace detail
+{
+/// deserializes a single token with archive_t.
+template <class data_t, class archive_t>
+struct token_deserializer
+{
+	data_t operator()(const token_file_reader::record_view& record)
+	{
+		return deserializer(record.payload());
+	}
+	single_object_deserializer<data_t, archive_t> deserializer;
+};
+} // namespace detail
+} // namespace recording
+
+/**
+ * \brief Node which fires events recorded by an event_recorder.
+ *
+ * On every work tick of its region, all events whose timestamp has been reached by
+ * virtual_clock::steady are deserialized and fired in the order they were recorded.
+ * Since playback follows the virtual clock, downstream nodes behave the same as
+ * during recording regardless of the main loop and its warp factor.
+ *
+ * The file is memory mapped and never loaded completely.
+ *
+ * \tparam data_t type of events replayed, may be void.
+ * \tparam archive_t cereal input archive matching the archive used for recording.
+ * \ingroup nodes
+ */
+template <class data_t, class archive_t>
+class event_replay final : public region_worker_node
+{
+public:
+	static constexpr auto default_name = "event_replay";
+
+	/// \param file_name file written by event_recorder<data_t, output archive>.
+	event_replay(const std::string& file_name, const node_args& node)
+		: region_worker_node([this]() { fire_due(); }, node)
+		, records(file_name)
+		, deserialize()
+		, out_event(this)
+	{
+	}
+
+	event_replay(const event_replay&) = delete;
+	event_replay(event_replay&&) = delete;
+
+	/// Event source of type data_t
+	auto& out() { return out_event; }
+
+	/// Continues replay at the first event recorded at or after t, see playback::seek.
+	void seek(virtual_clock::steady::time_point t) { records.seek(t); }
+
+	/// returns true if all events of the file have been fired.
+	bool done() const { return records.done(); }
+
+private:
+	void fire_due()
+	{
+		records.play_due([this](const recording::token_file_reader::record_view& record)
+				{
+					out_event.fire(deserialize(record));
+				});
+	}
+
+	recording::playback records;
+	recording::detail::token_deserializer<data_t, archive_t> deserialize;
+	event_source<data_t> out_event;
+};
+
+/// Specialization for void events, which have no payload to deserialize.
+template <class archive_t>
+class event_replay<void, archive_t> final : public region_worker_node
+{
+public:
+	static constexpr auto default_name = "event_replay";
+
+	event_replay(const std::string& file_name, const node_args& node)
+		: region_worker_node([this]() { fire_due(); }, node)
+		, records(file_name)
+		, out_event(this)
+	{
+	}
+
+	event_replay(const event_replay&) = delete;
+	event_replay(event_replay&&) = delete;
+
+	/// Event source of type void
+	auto& out() { return out_event; }
+
+	/// Continues replay at the first event recorded at or after t, see playback::seek.
+	void seek(virtual_clock::steady::time_point t) { records.seek(t); }
+
+	/// returns true if all events of the file have been fired.
+	bool done() const { return records.done(); }
+
+private:
+	void fire_due()
+	{
+		records.play_due([this](const recording::token_file_reader::record_view&)
+				{
+					out_event.fire();
+				});
+	}
+
+	recording::playback records;
+	event_source<void> out_event;
+};
+
+/**
+ * \brief Node which provides states recorded by a state_recorder.
+ *
+ * On every work tick of its region playback advances to the latest state whose
+ * timestamp has been reached by virtual_clock::steady.
+ * Only this state is deserialized, and only once it is pulled.
+ * Before the first recorded state is reached, the initial value is provided.
+ *
+ * \tparam data_t type of state replayed.
+ * \tparam archive_t cereal input archive matching the archive used for recording.
+ * \ingroup nodes
+ */
+template <class data_t, class archive_t>
+class state_replay final : public region_worker_node
+{
+public:
+	static constexpr auto default_name = "state_replay";
+
+	/// \param file_name file written by state_recorder<data_t, output archive>.
+	state_replay(const std::string& file_name, const node_args& node)
+		: state_replay(file_name, data_t{}, node)
+	{
+	}
+
+	state_replay(const std::string& file_name, const data_t& initial_value,
+			const node_args& node)
+		: region_worker_node([this]() { advance(); }, node)
+		, records(file_name)
+		, deserialize()
+		, latest()
+		, has_new(false)
+		, current(initial_value)
+		, out_state(this, [this]() { return get(); })
+	{
+	}
+
+	state_replay(const state_replay&) = delete;
+	state_replay(state_replay&&) = delete;
+
+	/// State source of type data_t
+	auto& out() { return out_state; }
+
+	/// Continues replay at the first state recorded at or after t, see playback::seek.
+	void seek(virtual_clock::steady::time_point t) { records.seek(t); }
+
+	/// returns true if the last state of the file has been reached.
+	bool done() const { return records.done(); }
+
+private:
+	void advance()
+	{
+		records.play_due([this](const recording::token_file_reader::record_view& record)
+				{
+					latest = record;
+					has_new = true;
+				});
+	}
+
+	const data_t& get()
+	{
+		if (has_new)
+		{
+			current = deserialize(latest);
+			has_new = false;
+		}
+		return current;
+	}
+
+	recording::playback records;
+	recording::detail::token_deserializer<data_t, archive_t> deserialize;
+	recording::token_file_reader::record_view latest;
+	bool has_new;
+	data_t current;
+	state_source<data_t> out_state;
+};
+
+} // namespace fc
+
+#endif /* FLEXCORE_EXTENDED_NODES_REPLAY_HPP_ */
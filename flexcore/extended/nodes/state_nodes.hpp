@@ -1,6 +1,7 @@
 #ifndef SRC_NODES_STATE_NODES_HPP_
 #define SRC_NODES_STATE_NODES_HPP_
 
+#include <flexcore/core/shared.hpp>
 #include <flexcore/core/traits.hpp>
 #include <flexcore/core/tuple_meta.hpp>
 #include <flexcore/extended/ports/node_aware.hpp>
@@ -203,9 +204,19 @@ public:
 			[this]()
 			{
 				stored_state = in_port.get();
+				snapshot_outdated = true;
 			}, node),
 			in_port(this),
 			out_port(this, [this](){ return stored_state;}),
+			snapshot_port(this, [this]()
+			{
+				if (snapshot_outdated)
+				{
+					current_snapshot = share(stored_state);
+					snapshot_outdated = false;
+				}
+				return current_snapshot;
+			}),
 			stored_state(initial_value)
 	{
 	}
@@ -217,11 +228,26 @@ public:
 	auto& in() noexcept { return in_port; }
 	/// State Output Port of type data_t.
 	auto& out() noexcept { return out_port; }
+	/**
+	 * \brief State Output Port of immutable snapshots of the cached state.
+	 *
+	 * The state is copied into a snapshot on the first pull after it changed,
+	 * all further pulls share that snapshot.
+	 * Thus large states are copied at most once per tick instead of on every pull,
+	 * and not at all if snapshot is not pulled.
+	 * A snapshot stays valid and unchanged as long as it is held, also after the next tick.
+	 */
+	auto& snapshot() noexcept { return snapshot_port; }
 
 private:
 	state_sink<data_t> in_port;
 	state_source<data_t> out_port;
+	state_source<shared<data_t>> snapshot_port;
 	data_t stored_state;
+	/// copy of stored_state handed out by snapshot, made when pulled.
+	shared<data_t> current_snapshot;
+	/// true if stored_state changed since current_snapshot was made.
+	bool snapshot_outdated = true;
 };
 
 /**
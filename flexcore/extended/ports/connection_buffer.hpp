@@ -1,8 +1,19 @@
 #ifndef SRC_PORTS_CONNECTION_BUFFER_HPP_
 #define SRC_PORTS_CONNECTION_BUFFER_HPP_
 
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <functional>
+#include <limits>
 #include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include <flexcore/pure/pure_ports.hpp>
 #include <flexcore/extended/ports/token_tags.hpp>
@@ -13,6 +24,64 @@ namespace fc
 //Note: Many asserts in this file might seem stupid (like checking empty after clear)
 //but this code is multi-threaded and race conditions might trigger them.
 
+/// Occupancy of a buffer between regions.
+struct buffer_metrics
+{
+	/// tokens currently stored in the buffer
+	std::size_t depth = 0;
+	/// maximum depth since construction of the buffer
+	std::size_t high_watermark = 0;
+	/// events dropped, because the buffer was full
+	std::uint64_t dropped = 0;
+	/// events merged into waiting events by the event_coalescing of the buffer
+	std::uint64_t coalesced = 0;
+};
+
+/// What an event_buffer does with a new event when it is full.
+enum class overflow_policy
+{
+	/// the oldest event waiting in the buffer is dropped.
+	drop_oldest,
+	/// the new event is dropped.
+	drop_newest,
+	/**
+	 * \brief the producer waits until the consumer takes events, at most for block_timeout.
+	 *
+	 * Only events switched to the consumer can be taken while the producer waits.
+	 * If the events of the current tick of the producer fill the buffer alone,
+	 * new events are dropped without waiting.
+	 */
+	block
+};
+
+/**
+ * \brief Capacity and overflow behaviour of event_buffers.
+ *
+ * The capacity limits the events which have not yet been passed to the work tick of the
+ * receiving region. By default buffers are unbounded.
+ */
+struct event_buffer_policy
+{
+	/// \invariant capacity > 0
+	std::size_t capacity = std::numeric_limits<std::size_t>::max();
+	overflow_policy on_overflow = overflow_policy::drop_oldest;
+	/**
+	 * \brief longest time a blocked producer waits, the new event is dropped afterwards.
+	 *
+	 * Buffers are only switched after the producing region finished its work tick,
+	 * a producer waiting without timeout could thus wait forever.
+	 */
+	std::chrono::milliseconds block_timeout{10};
+};
+
+/// common base of all buffers, which makes their metrics available without knowing their type.
+struct buffer_base
+{
+	virtual ~buffer_base() = default;
+	/// returns current occupancy of the buffer, buffers without storage return zeros.
+	virtual buffer_metrics metrics() const { return buffer_metrics{}; }
+};
+
 /**
  * \brief common interface of nodes serving as buffers within connections.
  *
@@ -23,7 +92,7 @@ namespace fc
  * \tparam tag either event_tag or state_tag, specifies if events or states are buffered.
  */
 template<class token_t, class tag>
-struct buffer_interface
+struct buffer_interface : buffer_base
 {
 	using out_port_t = typename pure::out_port<token_t, tag>::type;
 	using in_port_t = typename pure::in_port<token_t, tag>::type;
@@ -66,6 +135,287 @@ private:
 	pure::event_sink<token_t> in_event_port;
 	pure::event_source<token_t> out_event_port;
 };
+namespace detail
+{
+/**
+ * \brief vector of events, which supports removing the oldest event in amortized constant time.
+ *
+ * Removed events stay in storage until more than half of it is unused.
+ */
+template<class event_t>
+class event_queue
+{
+public:
+	using iterator = typename std::vector<event_t>::iterator;
+
+	std::size_t size() const { return storage.size() - front; }
+	bool empty() const { return size() == 0; }
+
+	iterator begin() { return storage.begin() + front; }
+	iterator end() { return storage.end(); }
+	event_t& back() { assert(!empty()); return storage.back(); }
+
+	template<class T>
+	void push_back(T&& event) { storage.push_back(std::forward<T>(event)); }
+
+	void append(event_queue& other)
+	{
+		storage.insert(storage.end(), other.begin(), other.end());
+	}
+
+	void pop_front()
+	{
+		assert(!empty());
+		++front;
+		if (2 * front >= storage.size())
+		{
+			storage.erase(storage.begin(), storage.begin() + front);
+			front = 0;
+		}
+	}
+
+	/// removes all events, but keeps capacity to avoid allocations in the next cycle.
+	void clear()
+	{
+		storage.clear();
+		front = 0;
+	}
+
+	friend void swap(event_queue& lhs, event_queue& rhs)
+	{
+		using std::swap;
+		swap(lhs.storage, rhs.storage);
+		swap(lhs.front, rhs.front);
+	}
+
+private:
+	std::vector<event_t> storage;
+	std::size_t front = 0;
+};
+} // namespace detail
+
+/**
+ * \brief Combines events of event_t, which wait in an event_buffer for the same delivery.
+ *
+ * Events fired by a fast region into a slow region are merged while they wait,
+ * thus the receiving region only handles what it needs
+ * and the work of the buffer and its receivers scales with the rate of the receiving region.
+ * Coalescing is applied before the capacity, merged events do not fill the buffer.
+ * \see keep_latest, keep_latest_per_key, fold_events, node_aware::set_coalescing
+ */
+template<class event_t>
+struct event_coalescing
+{
+	virtual ~event_coalescing() = default;
+
+	/**
+	 * \brief merges event into one of the events waiting in queue.
+	 * \returns true if event was merged, false if it needs to be appended to queue.
+	 */
+	virtual bool merge(detail::event_queue<event_t>& queue, event_t& event) const = 0;
+};
+
+namespace detail
+{
+template<class event_t>
+struct latest_coalescing final : event_coalescing<event_t>
+{
+	bool merge(event_queue<event_t>& queue, event_t& event) const override
+	{
+		if (queue.empty())
+			return false;
+		queue.back() = std::move(event);
+		return true;
+	}
+};
+
+template<class event_t, class key_t>
+struct latest_per_key_coalescing final : event_coalescing<event_t>
+{
+	explicit latest_per_key_coalescing(key_t key) : key(std::move(key)) {}
+
+	bool merge(event_queue<event_t>& queue, event_t& event) const override
+	{
+		const auto new_key = key(event);
+		const auto same_key = std::find_if(queue.begin(), queue.end(),
+				[this, &new_key](const event_t& waiting) { return key(waiting) == new_key; });
+		if (same_key == queue.end())
+			return false;
+		*same_key = std::move(event);
+		return true;
+	}
+
+	key_t key;
+};
+
+template<class event_t, class fold_t>
+struct fold_coalescing final : event_coalescing<event_t>
+{
+	explicit fold_coalescing(fold_t fold) : fold(std::move(fold)) {}
+
+	bool merge(event_queue<event_t>& queue, event_t& event) const override
+	{
+		if (queue.empty())
+			return false;
+		queue.back() = fold(std::move(queue.back()), std::move(event));
+		return true;
+	}
+
+	fold_t fold;
+};
+} // namespace detail
+
+/// Coalescing, which only delivers the newest event of every tick.
+template<class event_t>
+std::shared_ptr<const event_coalescing<event_t>> keep_latest()
+{
+	return std::make_shared<detail::latest_coalescing<event_t>>();
+}
+
+/**
+ * \brief Coalescing, which delivers the newest event of every key per tick.
+ *
+ * A newer event replaces the waiting event with the same key,
+ * events are delivered in order of the first event of their key.
+ * \param key function object key_t(const event_t&), keys need to be equality comparable.
+ * Keys are searched linearly, thus the number of keys per tick should be small.
+ */
+template<class event_t, class key_t>
+auto keep_latest_per_key(key_t&& key)
+{
+	return std::shared_ptr<const event_coalescing<event_t>>{std::make_shared<
+			detail::latest_per_key_coalescing<event_t, std::decay_t<key_t>>>(
+					std::forward<key_t>(key))};
+}
+
+/**
+ * \brief Coalescing, which folds all events of a tick into a single event.
+ *
+ * \param fold function object event_t(event_t waiting, event_t newer),
+ * which combines the waiting event with a newer event.
+ */
+template<class event_t, class fold_t>
+auto fold_events(fold_t&& fold)
+{
+	return std::shared_ptr<const event_coalescing<event_t>>{std::make_shared<
+			detail::fold_coalescing<event_t, std::decay_t<fold_t>>>(std::forward<fold_t>(fold))};
+}
+
+namespace detail
+{
+
+/**
+ * \brief Policy, metrics and synchronisation shared by all event_buffers.
+ *
+ * The depth of the three stages of a buffer is kept in atomics,
+ * as they are written by the producing and consuming region and read by monitors.
+ * The middle stage is only accessed with middle_mutex locked.
+ */
+class buffer_occupancy
+{
+public:
+	explicit buffer_occupancy(const event_buffer_policy& policy)
+		: policy(policy)
+	{
+		assert(policy.capacity > 0);
+	}
+
+	buffer_metrics metrics() const
+	{
+		buffer_metrics result;
+		result.depth = depth();
+		result.high_watermark = high_watermark.load(std::memory_order_relaxed);
+		result.dropped = dropped.load(std::memory_order_relaxed);
+		result.coalesced = coalesced.load(std::memory_order_relaxed);
+		return result;
+	}
+
+	/// events waiting for the next switch to the receiving region.
+	std::size_t pending() const
+	{
+		return intern_depth.load(std::memory_order_relaxed)
+				+ middle_depth.load(std::memory_order_relaxed);
+	}
+
+	bool full() const { return pending() >= policy.capacity; }
+
+	/// called by the producing region, which owns the intern stage.
+	void set_intern_depth(std::size_t intern)
+	{
+		intern_depth.store(intern, std::memory_order_relaxed);
+		update_high_watermark();
+	}
+
+	/// called with middle_mutex locked.
+	void set_middle_depth(std::size_t middle)
+	{
+		middle_depth.store(middle, std::memory_order_relaxed);
+	}
+
+	/// called by the receiving region, which owns the extern stage.
+	void set_extern_depth(std::size_t extern_)
+	{
+		extern_depth.store(extern_, std::memory_order_relaxed);
+	}
+
+	/// events switched to the receiving region, which are sent on its next work tick.
+	std::size_t deliverable() const { return extern_depth.load(std::memory_order_relaxed); }
+
+	void count_dropped() { dropped.fetch_add(1, std::memory_order_relaxed); }
+	void count_coalesced() { coalesced.fetch_add(1, std::memory_order_relaxed); }
+
+	/**
+	 * \brief waits until the buffer is not full anymore or block_timeout passed.
+	 *
+	 * Returns immediately if the intern stage alone fills the buffer,
+	 * as only the switch tick of the waiting producer empties it.
+	 * \param lock lock of middle_mutex
+	 * \param intern number of events in the intern stage
+	 * \returns true if the buffer is not full.
+	 */
+	bool wait_for_space(std::unique_lock<std::mutex>& lock, std::size_t intern)
+	{
+		if (intern >= policy.capacity)
+			return false;
+		return space_available.wait_for(lock, policy.block_timeout, [this]() { return !full(); });
+	}
+
+	/// wakes producers waiting for space, call after events left the pending stages.
+	void notify_space()
+	{
+		if (policy.on_overflow == overflow_policy::block)
+			space_available.notify_all();
+	}
+
+	const event_buffer_policy policy;
+	mutable std::mutex middle_mutex;
+
+private:
+	std::size_t depth() const
+	{
+		return pending() + extern_depth.load(std::memory_order_relaxed);
+	}
+
+	void update_high_watermark()
+	{
+		const auto current = depth();
+		auto highest = high_watermark.load(std::memory_order_relaxed);
+		while (current > highest
+				&& !high_watermark.compare_exchange_weak(highest, current,
+						std::memory_order_relaxed))
+		{
+		}
+	}
+
+	std::atomic<std::size_t> intern_depth{0};
+	std::atomic<std::size_t> middle_depth{0};
+	std::atomic<std::size_t> extern_depth{0};
+	std::atomic<std::size_t> high_watermark{0};
+	std::atomic<std::uint64_t> dropped{0};
+	std::atomic<std::uint64_t> coalesced{0};
+	std::condition_variable space_available;
+};
+} // namespace detail
 
 /**
  * \brief buffer for events using double buffering
@@ -75,20 +425,29 @@ private:
  * This moves events from internal to external buffer.
  * New events are added to to the internal buffer.
  * Events from the external buffer are fired on receiving send tick.
+ *
+ * The number of events waiting for the receiving region can be bounded by an
+ * event_buffer_policy, which also decides what happens to events when the buffer is full.
+ * With an event_coalescing, events waiting for the same delivery are merged,
+ * also if they were fired in several ticks of the sending region.
  */
 template<class event_t>
 class event_buffer final : public buffer_interface<event_t, event_tag>
 {
 public:
-	event_buffer()
+	/// \param coalescing merges waiting events, all events are kept if nullptr.
+	explicit event_buffer(const event_buffer_policy& policy = event_buffer_policy{},
+			std::shared_ptr<const event_coalescing<event_t>> coalescing = nullptr)
 		: switch_active_tick_([this] { switch_active_buffers(); })
 		, switch_passive_tick_([this] { switch_passive_buffers(); })
 		, switch_active_passive_tick_([this] { switch_active_passive_buffers(); })
 		, in_send_tick( [this](){ send_events(); } )
-		, in_event_port( [this](event_t in_event) { intern_buffer.push_back(in_event);})
+		, in_event_port( [this](event_t in_event) { push(std::move(in_event)); })
 		, intern_buffer()
 		, extern_buffer()
 		, read(false)
+		, occupancy(policy)
+		, coalescing(std::move(coalescing))
 	{
 	}
 
@@ -107,7 +466,89 @@ public:
 	in_port_t& in() override { return in_event_port; }
 	out_port_t& out() override { return out_event_port; }
 
+	buffer_metrics metrics() const override { return occupancy.metrics(); }
+	/// true if events are waiting to be sent on the next work tick.
+	bool has_deliverable_events() const { return occupancy.deliverable() != 0; }
+
 private:
+	/// stores a new event in intern_buffer, applies the overflow policy if the buffer is full.
+	void push(event_t&& event)
+	{
+		if (coalescing && coalescing->merge(intern_buffer, event))
+		{
+			occupancy.count_coalesced();
+			return;
+		}
+		if (occupancy.full() && !make_space())
+			return;
+		intern_buffer.push_back(std::move(event));
+		occupancy.set_intern_depth(intern_buffer.size());
+	}
+
+	/**
+	 * \brief appends the events of source to target, coalescing them with the events of target.
+	 * \post source.empty()
+	 */
+	void append(detail::event_queue<event_t>& target, detail::event_queue<event_t>& source)
+	{
+		if (!coalescing)
+		{
+			target.append(source);
+		}
+		else
+		{
+			for (auto& event : source)
+			{
+				if (coalescing->merge(target, event))
+					occupancy.count_coalesced();
+				else
+					target.push_back(std::move(event));
+			}
+		}
+		source.clear();
+	}
+
+	/**
+	 * \brief applies the overflow policy to a full buffer
+	 * \returns true if event is to be stored, false if it was dropped.
+	 */
+	bool make_space()
+	{
+		switch (occupancy.policy.on_overflow)
+		{
+		case overflow_policy::drop_newest:
+			occupancy.count_dropped();
+			return false;
+		case overflow_policy::drop_oldest:
+		{
+			// the consumer might have taken the middle stage since full was checked.
+			std::lock_guard<std::mutex> lock(occupancy.middle_mutex);
+			if (!occupancy.full())
+				return true;
+			occupancy.count_dropped();
+			if (!middle_buffer.empty())
+			{
+				middle_buffer.pop_front();
+				occupancy.set_middle_depth(middle_buffer.size());
+			}
+			else if (!intern_buffer.empty())
+			{
+				intern_buffer.pop_front();
+			}
+			return true;
+		}
+		case overflow_policy::block:
+		{
+			std::unique_lock<std::mutex> lock(occupancy.middle_mutex);
+			if (occupancy.wait_for_space(lock, intern_buffer.size()))
+				return true;
+			occupancy.count_dropped();
+			return false;
+		}
+		}
+		return false;
+	}
+
 	/**
 	 * \brief switches intern_buffer to middle_buffer
 	 * \post intern_buffer.empty()
@@ -115,15 +556,18 @@ private:
 	 */
 	void switch_active_buffers()
 	{
+		std::lock_guard<std::mutex> lock(occupancy.middle_mutex);
 		// If middle buffer has been switched with outgoing_buffer, then we can swap the incoming
 		// buffers without data loss. If middle buffer has not been read then data needs to be
 		// appended.
 		if (read)
 			swap(intern_buffer, middle_buffer);
 		else
-			middle_buffer.insert(end(middle_buffer), begin(intern_buffer), end(intern_buffer));
+			append(middle_buffer, intern_buffer);
 		read = false;
 		intern_buffer.clear();
+		occupancy.set_intern_depth(0);
+		occupancy.set_middle_depth(middle_buffer.size());
 		assert(intern_buffer.empty());
 		assert(!read);
 	}
@@ -135,13 +579,19 @@ private:
 	 */
 	void switch_passive_buffers()
 	{
-		// Switching the outgoing buffers means the previous value in extern_buffer has already been
-		// processed. So a new value is unconditionally needed. Swap should do.
-		swap(middle_buffer, extern_buffer);
-		read = true;
-		middle_buffer.clear();
-		assert(middle_buffer.empty());
-		assert(read);
+		{
+			std::lock_guard<std::mutex> lock(occupancy.middle_mutex);
+			// Switching the outgoing buffers means the previous value in extern_buffer has
+			// already been processed. So a new value is unconditionally needed. Swap should do.
+			swap(middle_buffer, extern_buffer);
+			read = true;
+			middle_buffer.clear();
+			occupancy.set_middle_depth(0);
+			occupancy.set_extern_depth(extern_buffer.size());
+			assert(middle_buffer.empty());
+			assert(read);
+		}
+		occupancy.notify_space();
 	}
 
 	/**
@@ -150,16 +600,21 @@ private:
 	 */
 	void switch_active_passive_buffers()
 	{
-		if(extern_buffer.empty())
-		{
-			swap(intern_buffer, extern_buffer);
-		}
-		else
 		{
-			extern_buffer.insert(end(extern_buffer), begin(intern_buffer), end(intern_buffer));
-			intern_buffer.clear();
+			std::lock_guard<std::mutex> lock(occupancy.middle_mutex);
+			if(extern_buffer.empty())
+			{
+				swap(intern_buffer, extern_buffer);
+			}
+			else
+			{
+				append(extern_buffer, intern_buffer);
+			}
+			occupancy.set_intern_depth(0);
+			occupancy.set_extern_depth(extern_buffer.size());
+			assert(intern_buffer.empty());
 		}
-		assert(intern_buffer.empty());
+		occupancy.notify_space();
 	}
 
 	/**
@@ -174,6 +629,7 @@ private:
 		// delete content of extern buffer, do not change capacity,
 		// since we want to avoid allocations in next cycle.
 		extern_buffer.clear();
+		occupancy.set_extern_depth(0);
 		assert(extern_buffer.empty());
 	}
 
@@ -184,32 +640,38 @@ private:
 	in_port_t in_event_port;
 	out_port_t out_event_port;
 
-	using buffer_t = std::vector<event_t>;
+	using buffer_t = detail::event_queue<event_t>;
 	buffer_t intern_buffer;
 	buffer_t extern_buffer;
 	buffer_t middle_buffer;
 	bool read;
+	detail::buffer_occupancy occupancy;
+	std::shared_ptr<const event_coalescing<event_t>> coalescing;
 };
 
 /**
  * \brief Template Specialization for events of type void
  *
  * Instead of real buffers we just count the events.
+ * As all events are equal, dropping the oldest or the newest are the same.
+ * Void events carry no data to coalesce,
+ * capacity 1 with overflow_policy::drop_newest keeps a single event instead.
  */
 template<>
 class event_buffer<void> final : public buffer_interface<void, event_tag>
 {
 public:
-	event_buffer()
+	explicit event_buffer(const event_buffer_policy& policy = event_buffer_policy{})
 		: switch_active_tick_([this] { switch_active_buffers(); })
 		, switch_passive_tick_([this] { switch_passive_buffers(); })
 		, switch_active_passive_tick_([this] { switch_active_passive_buffers(); })
 		, in_send_tick( [this](){ send_events(); } )
-		, in_event_port( [this]() { intern_buffer++;})
+		, in_event_port( [this]() { push(); })
 		, intern_buffer(0)
 		, extern_buffer(0)
 		, middle_buffer(0)
 		, read(false)
+		, occupancy(policy)
 		{
 		}
 
@@ -228,30 +690,68 @@ public:
 	in_port_t& in() override { return in_event_port; }
 	out_port_t& out() override { return out_event_port; }
 
+	buffer_metrics metrics() const override { return occupancy.metrics(); }
+	/// true if events are waiting to be sent on the next work tick.
+	bool has_deliverable_events() const { return occupancy.deliverable() != 0; }
+
 private:
+	void push()
+	{
+		if (occupancy.full())
+		{
+			std::unique_lock<std::mutex> lock(occupancy.middle_mutex);
+			// the consumer might have taken events since full was checked.
+			const bool has_space = !occupancy.full()
+					|| (occupancy.policy.on_overflow == overflow_policy::block
+							&& occupancy.wait_for_space(lock, intern_buffer));
+			if (!has_space)
+			{
+				occupancy.count_dropped();
+				return;
+			}
+		}
+		++intern_buffer;
+		occupancy.set_intern_depth(intern_buffer);
+	}
+
 	void switch_active_buffers()
 	{
+		std::lock_guard<std::mutex> lock(occupancy.middle_mutex);
 		if (read)
 			middle_buffer = intern_buffer;
 		else
 			middle_buffer += intern_buffer;
 		read = false;
 		intern_buffer = 0;
+		occupancy.set_intern_depth(0);
+		occupancy.set_middle_depth(middle_buffer);
 	}
 
 	void switch_passive_buffers()
 	{
-		// Switching the outgoing buffers means the previous value in extern_buffer has already been
-		// processed. So a new value is unconditionally needed. Swap should do.
-		std::swap(middle_buffer, extern_buffer);
-		read = true;
-		middle_buffer = 0;
+		{
+			std::lock_guard<std::mutex> lock(occupancy.middle_mutex);
+			// Switching the outgoing buffers means the previous value in extern_buffer has
+			// already been processed. So a new value is unconditionally needed. Swap should do.
+			std::swap(middle_buffer, extern_buffer);
+			read = true;
+			middle_buffer = 0;
+			occupancy.set_middle_depth(0);
+			occupancy.set_extern_depth(extern_buffer);
+		}
+		occupancy.notify_space();
 	}
 
 	void switch_active_passive_buffers()
 	{
-		extern_buffer += intern_buffer;
-		intern_buffer = 0;
+		{
+			std::lock_guard<std::mutex> lock(occupancy.middle_mutex);
+			extern_buffer += intern_buffer;
+			intern_buffer = 0;
+			occupancy.set_intern_depth(0);
+			occupancy.set_extern_depth(extern_buffer);
+		}
+		occupancy.notify_space();
 	}
 
 
@@ -265,6 +765,7 @@ private:
 			out_event_port.fire();
 
 		extern_buffer = 0;
+		occupancy.set_extern_depth(0);
 	}
 
 	pure::event_sink<void> switch_active_tick_;
@@ -278,6 +779,7 @@ private:
 	size_t extern_buffer;
 	size_t middle_buffer;
 	bool read;
+	detail::buffer_occupancy occupancy;
 };
 
 /// Implementation of buffer_interface, which directly forwards state.
@@ -363,34 +865,49 @@ private:
 namespace detail
 {
 template<class data_t, class tag>
-struct no_buffer {};
+struct buffer {};
 
 template<class data_t>
-struct no_buffer<data_t, event_tag>
+struct buffer<data_t, event_tag>
 {
-	using type = event_no_buffer<data_t>;
+	using type = event_buffer<data_t>;
 };
 
 template<class data_t>
-struct no_buffer<data_t, state_tag>
+struct buffer<data_t, state_tag>
 {
-	using type = state_no_buffer<data_t>;
+	using type = state_buffer<data_t>;
 };
 
-template<class data_t, class tag>
-struct buffer {};
+/**
+ * \param coalescing event_coalescing<data_t> or nullptr,
+ * type erased as only node_aware event_sources have one, see node_aware::set_coalescing.
+ */
+template<class data_t>
+auto make_buffer(event_tag, const event_buffer_policy& policy,
+		const std::shared_ptr<const void>& coalescing)
+		-> std::enable_if_t<!std::is_void<data_t>{}, std::shared_ptr<event_buffer<data_t>>>
+{
+	return std::make_shared<event_buffer<data_t>>(policy,
+			std::static_pointer_cast<const event_coalescing<data_t>>(coalescing));
+}
 
+/// void events can not be coalesced.
 template<class data_t>
-struct buffer<data_t, event_tag>
+auto make_buffer(event_tag, const event_buffer_policy& policy,
+		const std::shared_ptr<const void>& coalescing)
+		-> std::enable_if_t<std::is_void<data_t>{}, std::shared_ptr<event_buffer<void>>>
 {
-	using type = event_buffer<data_t>;
-};
+	assert(!coalescing);
+	return std::make_shared<event_buffer<void>>(policy);
+}
 
+/// state_buffers only store a single state, thus they are never full.
 template<class data_t>
-struct buffer<data_t, state_tag>
+auto make_buffer(state_tag, const event_buffer_policy&, const std::shared_ptr<const void>&)
 {
-	using type = state_buffer<data_t>;
-};
+	return std::make_shared<state_buffer<data_t>>();
+}
 }
 
 } // namespace fc
@@ -5,9 +5,12 @@
 #include <flexcore/core/connection_util.hpp>
 #include <flexcore/core/connection.hpp>
 #include <flexcore/extended/ports/connection_buffer.hpp>
+#include <flexcore/extended/ports/port_probe.hpp>
 #include <flexcore/scheduler/parallelregion.hpp>
 
 #include <functional>
+#include <memory>
+#include <vector>
 
 namespace fc
 {
@@ -33,63 +36,83 @@ bool same_tick_rate(const node_aware<source_t>& source,
 	return source.region().get_duration() == sink.region().get_duration();
 }
 
+namespace detail
+{
+/// event buffers only need the work tick of the receiving region, if they have events to send.
+template<class data_t>
+void add_work_trigger(parallel_region& region, const std::shared_ptr<event_buffer<data_t>>& buffer)
+{
+	const auto* target = buffer.get();
+	region.ticks.add_work_trigger(buffer, [target]() { return target->has_deliverable_events(); });
+}
+
+/// state buffers pull on every work tick, they are no trigger and keep the region running.
+template<class data_t>
+void add_work_trigger(parallel_region&, const std::shared_ptr<state_buffer<data_t>>&)
+{
+}
+}
+
 ///factory to construct a buffer depending on region and token_type
 template<class token_t>
 struct buffer_factory
 {
 	/**
-	 * \brief Creates buffer or no_buffer depending on regions of active and passive
-	 * \returns either buffer if the regions differ and no_buffer if they are from the same region.
+	 * \brief Creates buffer between the regions of active and passive
+	 *
+	 * Connections within a region have no buffer, they are connected directly.
+	 * \returns buffer connected to the ticks of both regions.
 	 * \param active active port of the connection
 	 * \param passive passive port of the connection
+	 * \param policy capacity and overflow policy of event_buffers
+	 * \param coalescing event_coalescing<token_t> of event_buffers or nullptr
+	 * \pre active and passive are in different regions.
 	 */
 	template<class active_t, class passive_t, class tag>
 	static auto construct_buffer(const active_t& active,
-			const passive_t& passive, tag)
+			const passive_t& passive, tag,
+			const event_buffer_policy& policy = event_buffer_policy{},
+			const std::shared_ptr<const void>& coalescing = nullptr)
 			-> std::shared_ptr<buffer_interface<token_t, tag>>
 	{
-		if (!same_region(active, passive))
+		assert(!same_region(active, passive));
+		auto result_buffer = detail::make_buffer<token_t>(tag{}, policy, coalescing);
+
+		if(same_tick_rate(active, passive))
 		{
-			auto result_buffer =
-					std::make_shared<typename detail::buffer<token_t, tag>::type>();
-
-			if(same_tick_rate(active, passive))
-			{
-				active.region().switch_tick() >> result_buffer->switch_active_passive_tick();
-			}
-			else
-			{
-				active.region().switch_tick() >> result_buffer->switch_active_tick();
-				passive.region().switch_tick() >> result_buffer->switch_passive_tick();
-			}
-			passive.region().work_tick() >> result_buffer->work_tick();
-
-			return result_buffer;
+			active.region().switch_tick() >> result_buffer->switch_active_passive_tick();
 		}
 		else
-			return std::make_shared<typename detail::no_buffer<token_t, tag>::type>();
+		{
+			active.region().switch_tick() >> result_buffer->switch_active_tick();
+			passive.region().switch_tick() >> result_buffer->switch_passive_tick();
+		}
+		passive.region().work_tick() >> result_buffer->work_tick();
+		detail::add_work_trigger(passive.region(), result_buffer);
+
+		return result_buffer;
 	}
 };
 
 /**
  * \brief Connection that contain a buffer_interface
  *
- * Connection that contains a buffer_interface (see buffer_factory).
- * This will be a buffer if source and sink are from different regions,
- * a no_buffer otherwise.
+ * Connection that contains a buffer_interface (see buffer_factory)
+ * between source and sink from different regions.
  *
  * \tparam base_connection connection type, the buffer is mixed into.
  * \invariant buffer != null_ptr
  */
 template<class base_connection>
-struct buffered_event_connection: base_connection
+struct buffered_event_connection: base_connection, private port_probe
 {
 	using result_t = typename base_connection::result_t;
 
+	/// \param probe counts tokens entering buffer, is a base to take no space if disabled.
 	buffered_event_connection(std::shared_ptr<
 			buffer_interface<result_t, event_tag>> new_buffer,
-			const base_connection& base) :
-			base_connection(base), buffer(new_buffer)
+			const base_connection& base, port_probe probe = port_probe{}) :
+			base_connection(base), port_probe(std::move(probe)), buffer(new_buffer)
 	{
 		assert(buffer);
 	}
@@ -98,6 +121,7 @@ struct buffered_event_connection: base_connection
 	void operator()(T&&... in)
 	{
 		assert(buffer);
+		count_buffered();
 		buffer->in()(std::forward<T>(in)...);
 	}
 
@@ -111,20 +135,21 @@ private:
  * remove this code duplication if possible
  */
 template<class base_connection>
-struct buffered_state_connection: base_connection
+struct buffered_state_connection: base_connection, private port_probe
 {
 	using result_t = typename base_connection::result_t;
 
 	buffered_state_connection(std::shared_ptr<
 			buffer_interface<result_t, state_tag>> new_buffer,
-			const base_connection& base) :
-			base_connection(base), buffer(new_buffer)
+			const base_connection& base, port_probe probe = port_probe{}) :
+			base_connection(base), port_probe(std::move(probe)), buffer(new_buffer)
 	{
 		assert(buffer);
 	}
 
 	result_t operator()(void)
 	{
+		count_buffered();
 		return buffer->out()();
 	}
 
@@ -156,7 +181,7 @@ template<class source_t, class sink_t, class buffer_t>
 auto make_buffered_connection(std::shared_ptr<
         buffer_interface<buffer_t, event_tag>> buffer,
         const source_t& /*source*/,  //only needed for type deduction
-        sink_t&& sink)
+        sink_t&& sink, port_probe probe = port_probe{})
 {
 	assert(buffer);
 	using base_connection_t = port_connection<
@@ -168,7 +193,7 @@ auto make_buffered_connection(std::shared_ptr<
 	connect(buffer->out(), std::forward<sink_t>(sink));
 
 	return buffered_event_connection<base_connection_t>(std::move(buffer),
-			base_connection_t());
+			base_connection_t(), std::move(probe));
 }
 
 /**
@@ -182,7 +207,8 @@ template<class source_t, class sink_t, class buffer_t>
 auto make_buffered_connection(std::shared_ptr<
 		buffer_interface<buffer_t, state_tag>> buffer,
 		source_t&& source,
-		const sink_t&) /*sink*/  //only needed for type deduction
+		const sink_t&, /*sink*/  //only needed for type deduction
+		port_probe probe = port_probe{})
 {
 	assert(buffer);
 	using base_connection_t =port_connection<source_t, typename sink_t::base_t, buffer_t>;
@@ -190,13 +216,17 @@ auto make_buffered_connection(std::shared_ptr<
 	connect(std::forward<source_t>(source), buffer->in());
 
 	return buffered_state_connection<base_connection_t>(std::move(buffer),
-			base_connection_t());
+			base_connection_t(), std::move(probe));
 }
 }  // namespace detail
 
 /**
  * \brief A mixin for elements that are aware of the node they belong to.
  * Used as mixin for ports and connections.
+ *
+ * Tokens passing through node_aware ports are counted,
+ * once port_counters are attached with attach_statistics
+ * and flexcore is built with FLEXCORE_ENABLE_PORT_STATISTICS.
  * \tparam base is type node_aware is mixed into.
  *
  * example:
@@ -205,7 +235,7 @@ auto make_buffered_connection(std::shared_ptr<
  * \endcode
  */
 template <class base>
-struct node_aware: base
+struct node_aware: detail::instrumented_port<base>
 {
 	static_assert(std::is_class<base>{},
 			"can only be mixed into clases, not primitives");
@@ -215,7 +245,8 @@ struct node_aware: base
 	///Constructor takes a reference to the region and forwards all other args.
 	template <class ... args>
 	node_aware(parallel_region& r, args&&... base_constructor_args)
-		: base(std::forward<args>(base_constructor_args)...), region_(r)
+		: detail::instrumented_port<base>(std::forward<args>(base_constructor_args)...)
+		, region_(r)
 	{
 	}
 
@@ -232,6 +263,45 @@ struct node_aware: base
 	///returns reference to parallel_region this mixin is associated with.
 	parallel_region& region() const { return region_; }
 
+	/**
+	 * \brief sets capacity and overflow policy of buffers of connections made afterwards.
+	 *
+	 * Connections made before keep their policy, thus the policy can be chosen per connection.
+	 * Only event_sources create event_buffers, other ports ignore the policy.
+	 */
+	void set_buffer_policy(const event_buffer_policy& policy)
+	{
+		assert(policy.capacity > 0);
+		buffer_policy_ = policy;
+	}
+	const event_buffer_policy& buffer_policy() const { return buffer_policy_; }
+
+	/**
+	 * \brief sets how buffers of connections made afterwards merge waiting events.
+	 *
+	 * Like the buffer policy, the coalescing can be chosen per connection.
+	 * Only event_sources of events other than void have a coalescing,
+	 * it needs to be made for their event type, see keep_latest.
+	 * \param coalescing nullptr to keep all events.
+	 */
+	template<class T = base,
+			class enable = std::enable_if_t<is_active_source<T>{}
+					&& !std::is_void<result_of_t<T>>{}>>
+	void set_coalescing(std::shared_ptr<const event_coalescing<result_of_t<T>>> coalescing)
+	{
+		coalescing_ = std::move(coalescing);
+	}
+
+	/// returns metrics of existing event_buffers to other regions created by this port.
+	std::vector<buffer_metrics> buffer_occupancy() const
+	{
+		std::vector<buffer_metrics> result;
+		for (const auto& weak_buffer : buffers_)
+			if (const auto buffer = weak_buffer.lock())
+				result.push_back(buffer->metrics());
+		return result;
+	}
+
 private:
 	// helper aliases to make method prototypes easier to read.
 	using connection_has_node_aware = std::true_type;
@@ -240,14 +310,34 @@ private:
 	using base_is_sink = std::false_type;
 
 	std::reference_wrapper<parallel_region> region_;
+	event_buffer_policy buffer_policy_;
+	/// event_coalescing<result_of_t<base>> given to set_coalescing, type erased for other ports.
+	std::shared_ptr<const void> coalescing_;
+	/// buffers between regions created by this port, owned by the connections.
+	std::vector<std::weak_ptr<const buffer_base>> buffers_;
 
+	/**
+	 * Connections within a region need no buffer and are connected directly,
+	 * thus they cost the same as connections of pure ports.
+	 * Both cases return the type of the direct connection,
+	 * as the region is only known at runtime.
+	 */
 	template <class conn_t>
 	auto connect_impl(conn_t&& conn, connection_has_node_aware)
 	{
-		return base::connect(
-		    introduce_buffer(std::forward<conn_t>(conn), is_active_source<base>{}));
+		using direct_connection_t = decltype(base::connect(std::forward<conn_t>(conn)));
+		if (same_region(*this, passive_end(conn, is_active_source<base>{})))
+			return base::connect(std::forward<conn_t>(conn));
+		base::connect(introduce_buffer(std::forward<conn_t>(conn), is_active_source<base>{}));
+		return direct_connection_t();
 	}
 
+	/// returns the port at the other end of conn, which is passive.
+	template <class conn_t>
+	static const auto& passive_end(const conn_t& conn, base_is_source) { return get_sink(conn); }
+	template <class conn_t>
+	static const auto& passive_end(const conn_t& conn, base_is_sink) { return get_source(conn); }
+
 	template <class conn_t>
 	auto connect_impl(conn_t&& conn, connection_doesnt_have_node_aware)
 	{
@@ -259,11 +349,13 @@ private:
 	{
 		using result_t = result_of_t<base_t>;
 		const auto& sink = get_sink(conn);
-		return detail::make_buffered_connection(
-				buffer_factory<result_t>::construct_buffer(
-						*this,  // event source is active, thus first
-						sink,  // event sink is passive thus second
-						event_tag()), *this, std::forward<conn_t>(conn));
+		auto buffer = buffer_factory<result_t>::construct_buffer(
+				*this,  // event source is active, thus first
+				sink,  // event sink is passive thus second
+				event_tag(), buffer_policy_, coalescing_);
+		buffers_.emplace_back(buffer);
+		return detail::make_buffered_connection(std::move(buffer), *this,
+				std::forward<conn_t>(conn), this->probe());
 	}
 
 	template <class conn_t>
@@ -275,7 +367,8 @@ private:
 				buffer_factory<result_t>::construct_buffer(
 						*this,  // state sink is active thus first
 						source,  // state source is passive thus second
-						state_tag()), std::forward<conn_t>(conn), *this);
+						state_tag()), std::forward<conn_t>(conn), *this,
+				this->probe());
 	}
 
 	template <class conn_t>
@@ -0,0 +1,272 @@
+#ifndef SRC_PORTS_PORT_PROBE_HPP_
+#define SRC_PORTS_PORT_PROBE_HPP_
+
+#include <flexcore/core/traits.hpp>
+#include <flexcore/extended/graph/port_statistics.hpp>
+#include <flexcore/utils/profiling/profiler.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace fc
+{
+
+/**
+ * \brief Size of tokens in bytes as counted by port statistics.
+ *
+ * Trivially copyable types count with their sizeof,
+ * contiguous containers of trivially copyable elements like std::vector<int> and std::string
+ * with the size of their elements.
+ * The size of all other types is unknown and counts as zero.
+ * Specialize this template to count bytes of other token types.
+ */
+template <class T, class enable = void>
+struct token_size
+{
+	constexpr std::size_t operator()(const T&) const { return 0; }
+};
+
+template <class T>
+struct token_size<T, std::enable_if_t<std::is_trivially_copyable<T>{}>>
+{
+	constexpr std::size_t operator()(const T&) const { return sizeof(T); }
+};
+
+template <class T>
+struct token_size<T, std::enable_if_t<!std::is_trivially_copyable<T>{}
+		&& std::is_same<decltype(std::declval<const T&>().data()),
+				const typename T::value_type*>{}
+		&& std::is_trivially_copyable<typename T::value_type>{}>>
+{
+	std::size_t operator()(const T& token) const
+	{
+		return token.size() * sizeof(typename T::value_type);
+	}
+};
+
+#ifdef FLEXCORE_ENABLE_PORT_STATISTICS
+
+/**
+ * \brief Updates the port_counters of a single port.
+ *
+ * Ports without counters attached are not counted.
+ * Handlers of ports with counters are recorded by the profiler as well,
+ * if it records node handlers.
+ * If flexcore is built without FLEXCORE_ENABLE_PORT_STATISTICS,
+ * port_probe is an empty class and all its methods do nothing.
+ */
+class port_probe
+{
+public:
+	port_probe() = default;
+	/// \param trace_name name of the handler in traces of the profiler
+	port_probe(std::shared_ptr<graph::port_counters> counters, profiler::name_id trace_name)
+		: counters(std::move(counters)), trace_name(trace_name)
+	{
+	}
+
+	template <class... token_t>
+	void count_fired(const token_t&... token) const
+	{
+		if (!counters)
+			return;
+		counters->fired.fetch_add(1, std::memory_order_relaxed);
+		count_bytes(token...);
+	}
+
+	template <class token_t>
+	void count_pulled(const token_t& token) const
+	{
+		if (!counters)
+			return;
+		counters->pulled.fetch_add(1, std::memory_order_relaxed);
+		count_bytes(token);
+	}
+
+	void count_buffered() const
+	{
+		if (counters)
+			counters->buffered.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	/// calls handler and adds the time it took to the handler time of the port.
+	template <class handler_t>
+	decltype(auto) time_handler(handler_t&& handler) const
+	{
+		const handler_timer timer{counters.get(), trace_name};
+		return handler();
+	}
+
+private:
+	void count_bytes() const {}
+
+	template <class token_t>
+	void count_bytes(const token_t& token) const
+	{
+		const auto bytes = token_size<std::decay_t<token_t>>{}(token);
+		if (bytes != 0)
+			counters->bytes.fetch_add(bytes, std::memory_order_relaxed);
+	}
+
+	/// adds the time between its construction and destruction to handler_ns
+	struct handler_timer
+	{
+		using clock = profiler::clock;
+
+		handler_timer(graph::port_counters* counters, profiler::name_id trace_name)
+			: counters(counters)
+			, trace_name(trace_name)
+			, start(counters ? clock::now() : clock::time_point{})
+		{
+		}
+
+		~handler_timer()
+		{
+			if (!counters)
+				return;
+			const auto end = clock::now();
+			const auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
+					end - start);
+			counters->handler_ns.fetch_add(duration.count(), std::memory_order_relaxed);
+			auto& trace = profiler::get();
+			if (trace.records_node_handlers())
+				trace.record(trace_category::node, trace_name, start, end);
+		}
+
+		graph::port_counters* counters;
+		profiler::name_id trace_name;
+		clock::time_point start;
+	};
+
+	std::shared_ptr<graph::port_counters> counters;
+	profiler::name_id trace_name = 0;
+};
+
+#else
+
+class port_probe
+{
+public:
+	port_probe() = default;
+	port_probe(const std::shared_ptr<graph::port_counters>&, profiler::name_id) {}
+
+	template <class... token_t>
+	void count_fired(const token_t&...) const {}
+	template <class token_t>
+	void count_pulled(const token_t&) const {}
+	void count_buffered() const {}
+	template <class handler_t>
+	decltype(auto) time_handler(handler_t&& handler) const { return handler(); }
+};
+
+#endif // FLEXCORE_ENABLE_PORT_STATISTICS
+
+namespace detail
+{
+
+/**
+ * \brief Holds the port_probe of a port, base of all instrumented_port specializations.
+ *
+ * The probe is a base instead of a member,
+ * thus it takes no space in ports, if port statistics are disabled.
+ */
+template <class base>
+struct probed_port : base, private port_probe
+{
+	template <class... args>
+	explicit probed_port(args&&... base_constructor_args)
+		: base(std::forward<args>(base_constructor_args)...)
+	{
+	}
+
+	/// attaches counters to this port, tokens are counted from now on.
+	void attach_statistics(
+			std::shared_ptr<graph::port_counters> counters, profiler::name_id trace_name)
+	{
+		static_cast<port_probe&>(*this) = port_probe{std::move(counters), trace_name};
+	}
+
+	const port_probe& probe() const { return *this; }
+};
+
+/**
+ * \brief Wraps the token interface of a port and counts the tokens with its port_probe.
+ *
+ * Specialized for the four kinds of ports,
+ * other connectables are not instrumented.
+ * The wrappers have the same signature as the ones of the port,
+ * thus traits of the port do not change.
+ */
+template <class base, class enable = void>
+struct instrumented_port : probed_port<base>
+{
+	using probed_port<base>::probed_port;
+};
+
+/// event_sources count events on fire.
+template <class base>
+struct instrumented_port<base, std::enable_if_t<is_active_source<base>{}>> : probed_port<base>
+{
+	using probed_port<base>::probed_port;
+
+	template <class... T>
+	void fire(T&&... event)
+	{
+		this->probe().count_fired(event...);
+		base::fire(std::forward<T>(event)...);
+	}
+};
+
+/// state_sinks count states on get.
+template <class base>
+struct instrumented_port<base, std::enable_if_t<is_active_sink<base>{}>> : probed_port<base>
+{
+	using probed_port<base>::probed_port;
+
+	auto get() const
+	{
+		auto state = base::get();
+		this->probe().count_pulled(state);
+		return state;
+	}
+};
+
+/// event_sinks count events and the time spent in their handler.
+template <class base>
+struct instrumented_port<base, std::enable_if_t<!is_active<base>{} && is_passive_sink<base>{}>>
+		: probed_port<base>
+{
+	using probed_port<base>::probed_port;
+
+	template <class... T>
+	auto operator()(T&&... event) -> decltype(std::declval<base&>()(std::forward<T>(event)...))
+	{
+		this->probe().count_fired(event...);
+		return this->probe().time_handler(
+				[&]() { return base::operator()(std::forward<T>(event)...); });
+	}
+};
+
+/// state_sources count states and the time spent to provide them.
+template <class base>
+struct instrumented_port<base, std::enable_if_t<!is_active<base>{} && is_passive_source<base>{}
+		&& !is_passive_sink<base>{}>> : probed_port<base>
+{
+	using probed_port<base>::probed_port;
+
+	decltype(std::declval<base&>()()) operator()()
+	{
+		auto state = this->probe().time_handler([this]() { return base::operator()(); });
+		this->probe().count_pulled(state);
+		return state;
+	}
+};
+
+} // namespace detail
+
+} // namespace fc
+
+#endif /* SRC_PORTS_PORT_PROBE_HPP_ */
@@ -66,11 +66,23 @@ infrastructure::add_region(const std::string& name,
 }
 
 infrastructure::infrastructure()
-    : scheduler(std::make_unique<fc::thread::parallel_scheduler>())
+    : infrastructure(clock_context::process_context())
+{
+}
+
+infrastructure::infrastructure(std::shared_ptr<clock_context> clocks)
+    : infrastructure(std::move(clocks), std::make_unique<fc::thread::parallel_scheduler>())
+{
+}
+
+infrastructure::infrastructure(std::shared_ptr<clock_context> clocks,
+		std::unique_ptr<thread::scheduler> work_scheduler)
+    : scheduler(std::move(work_scheduler))
     , region_maker(std::make_shared<detail::region_factory>(scheduler))
     , graph()
     , forest_root(graph, "root", add_region("root_region", thread::cycle_control::medium_tick))
 {
+	scheduler.set_clocks(std::move(clocks));
 }
 
 infrastructure::~infrastructure()
@@ -88,6 +100,18 @@ void infrastructure::iterate_main_loop()
 	}
 }
 
+void infrastructure::run_cycles(std::size_t cycles)
+{
+	for (std::size_t i = 0; i != cycles; ++i)
+	{
+		scheduler.wait_for_current_tasks();
+		scheduler.work();
+	}
+	scheduler.wait_for_all_tasks();
+	if (auto ex = scheduler.last_exception())
+		std::rethrow_exception(ex);
+}
+
 void infrastructure::infinite_main_loop()
 {
 	while( true )
@@ -4,6 +4,9 @@
 #include <flexcore/extended/base_node.hpp>
 #include <flexcore/scheduler/cyclecontrol.hpp>
 
+#include <cstddef>
+#include <memory>
+
 namespace fc
 {
 namespace detail {
@@ -13,7 +16,22 @@ class region_factory;
 class infrastructure
 {
 public:
+	/// constructs infrastructure which uses the clocks of the clock_context::process_context.
 	infrastructure();
+	/**
+	 * \brief constructs infrastructure which uses the given clocks.
+	 * Infrastructures with separate clocks are independent simulations,
+	 * which can be run in parallel in threads of a single process.
+	 * \pre clocks != nullptr
+	 */
+	explicit infrastructure(std::shared_ptr<clock_context> clocks);
+	/**
+	 * \brief constructs infrastructure which uses the given clocks and scheduler for work ticks.
+	 * \pre clocks != nullptr
+	 * \pre scheduler != nullptr
+	 */
+	infrastructure(std::shared_ptr<clock_context> clocks,
+			std::unique_ptr<thread::scheduler> scheduler);
 	~infrastructure();
 
 	std::shared_ptr<parallel_region> add_region(const std::string& name,
@@ -21,11 +39,18 @@ public:
 
 	owning_base_node& node_owner() { return forest_root.nodes(); }
 	graph::connection_graph& get_graph() { return graph; }
+	/// clocks of this infrastructure, bind them to access its virtual time from other threads.
+	clock_context& clocks() const { return scheduler.clocks(); }
 	void visualize(std::ostream& out) { forest_root.visualize(out); }
 	void infinite_main_loop();
 	void start_scheduler() { scheduler.start(); }
 	void stop_scheduler() { scheduler.stop(); }
 	void iterate_main_loop();
+	/**
+	 * \brief executes cycles as fast as possible on the calling thread.
+	 * \pre scheduler is not started
+	 */
+	void run_cycles(std::size_t cycles);
 
 private:
 	thread::cycle_control scheduler;
@@ -14,6 +14,8 @@ namespace fc
  * \brief mixin for ports, which makes them aware of parent node and available in graph.
  *
  * Use these ports together with tree_base_node and owning_base_node.
+ * If flexcore is built with FLEXCORE_ENABLE_PORT_STATISTICS, the ports count their tokens
+ * in graph::connection_graph::statistics() under the id of their graph_port_info.
  * \ingroup ports
  */
 template<class port_t>
@@ -35,6 +37,10 @@ struct node_aware_mixin : graph::graph_connectable<node_aware<port_t>>
 				std::forward<args>(base_constructor_args)...)
 	{
 		assert(node_ptr);
+#ifdef FLEXCORE_ENABLE_PORT_STATISTICS
+		this->attach_statistics(node_ptr->get_graph().statistics().register_port(
+				this->graph_port_info.id()), profiler::get().intern(node_ptr->name()));
+#endif
 	}
 };
 
@@ -10,6 +10,7 @@
 
 #include <cassert>
 #include <memory>
+#include <type_traits>
 #include <vector>
 
 namespace fc
@@ -53,11 +54,8 @@ struct event_source
 				"tried to call fire with a type, not implicitly convertible to type of port."
 				"If conversion is required, do the cast before calling fire.");
 
-		for (auto& target : base.storage.handlers)
-		{
-			assert(target);
-			target(static_cast<event_t>(event)...);
-		}
+		// events of other types are converted once, all handlers get the same token.
+		dispatch(convert(std::forward<T>(event))...);
 	}
 
 	/// Gives the number of connections from this port.
@@ -97,6 +95,29 @@ struct event_source
 	}
 
 private:
+	template<class... T>
+	void dispatch(T&&... event)
+	{
+		for (auto& target : base.storage.handlers)
+		{
+			assert(target);
+			target(static_cast<event_t>(event)...);
+		}
+	}
+
+	template<class T, class = std::enable_if_t<std::is_same<std::decay_t<T>, std::decay_t<event_t>>{}>>
+	static T&& convert(T&& event)
+	{
+		return std::forward<T>(event);
+	}
+
+	template<class T, class = std::enable_if_t<!std::is_same<std::decay_t<T>, std::decay_t<event_t>>{}>,
+			class = void>
+	static std::decay_t<event_t> convert(T&& event)
+	{
+		return static_cast<std::decay_t<event_t>>(std::forward<T>(event));
+	}
+
 	using handler_t = typename detail::handle_type<result_t>::type;
 	// Stores event_handlers in a vector, the node needs to send
 	// to all connected event_handlers when an event is fired.
@@ -0,0 +1,184 @@
+#ifndef FLEXCORE_PURE_SHM_PORTS_HPP_
+#define FLEXCORE_PURE_SHM_PORTS_HPP_
+
+#include <flexcore/pure/event_sinks.hpp>
+#include <flexcore/pure/event_sources.hpp>
+#include <flexcore/pure/state_sink.hpp>
+#include <flexcore/utils/ipc/channels.hpp>
+
+#include <cstddef>
+#include <string>
+
+namespace fc
+{
+namespace pure
+{
+
+/**
+ * \brief Event sink which forwards events to another process through shared memory.
+ *
+ * Creates the shared memory queue name, the receiving process opens it with
+ * a shm_event_source of the same event type.
+ * Events are copied directly into the queue, no serialization takes place.
+ * If the queue is full, events are dropped and counted.
+ *
+ * shm_event_sink fulfills passive_sink.
+ * \tparam event_t type of events, needs to be trivially copyable.
+ * \ingroup ports
+ */
+template <class event_t>
+class shm_event_sink
+{
+public:
+	static constexpr std::size_t default_capacity = 1024;
+
+	using result_t = void;
+	using token_t = event_t;
+
+	/// \throws std::system_error if shared memory object name exists already.
+	explicit shm_event_sink(const std::string& name, std::size_t capacity = default_capacity)
+		: queue(ipc::spsc_ring<event_t>::create(name, capacity))
+		, dropped(0)
+	{
+	}
+
+	void operator()(const event_t& event)
+	{
+		if (!queue.push(event))
+			++dropped;
+	}
+
+	/// number of events which were dropped, since the queue was full.
+	std::size_t nr_dropped() const { return dropped; }
+
+private:
+	ipc::spsc_ring<event_t> queue;
+	std::size_t dropped;
+};
+
+/**
+ * \brief Event source which fires events received from another process.
+ *
+ * Opens the shared memory queue created by a shm_event_sink.
+ * Received events are fired directly from the queue,
+ * when poll is called or poll_tick receives an event.
+ *
+ * shm_event_source fulfills active_source.
+ * \tparam event_t type of events, needs to be trivially copyable.
+ * \ingroup ports
+ */
+template <class event_t>
+class shm_event_source : public event_source<event_t>
+{
+public:
+	/**
+	 * \throws std::system_error if shared memory object name does not exist.
+	 * \throws std::runtime_error if it does not contain a queue of event_t.
+	 */
+	explicit shm_event_source(const std::string& name)
+		: queue(ipc::spsc_ring<event_t>::open(name))
+		, poll_sink([this]() { poll(); })
+	{
+	}
+
+	shm_event_source(const shm_event_source&) = delete;
+	shm_event_source(shm_event_source&&) = delete;
+
+	/**
+	 * \brief fires all events currently in the queue.
+	 * \returns number of events fired.
+	 */
+	std::size_t poll()
+	{
+		return queue.consume_all([this](const event_t& event) { this->fire(event); });
+	}
+
+	/// Event sink of type void which polls the queue, connect it to a work tick.
+	auto& poll_tick() { return poll_sink; }
+
+private:
+	ipc::spsc_ring<event_t> queue;
+	event_sink<void> poll_sink;
+};
+
+/**
+ * \brief State sink which publishes the pulled state to other processes.
+ *
+ * Creates the shared memory object name, other processes read the state
+ * with a shm_state_source.
+ * The state is pulled and published, when publish is called
+ * or publish_tick receives an event.
+ *
+ * shm_state_sink fulfills active_sink.
+ * \tparam data_t type of state, needs to be trivially copyable.
+ * \ingroup ports
+ */
+template <class data_t>
+class shm_state_sink : public state_sink<data_t>
+{
+public:
+	/// \throws std::system_error if shared memory object name exists already.
+	explicit shm_state_sink(const std::string& name)
+		: slot(ipc::seqlock_slot<data_t>::create(name))
+		, publish_sink([this]() { publish(); })
+	{
+	}
+
+	shm_state_sink(const shm_state_sink&) = delete;
+	shm_state_sink(shm_state_sink&&) = delete;
+
+	/// pulls the current state and writes it to shared memory.
+	void publish() { slot.store(this->get()); }
+
+	/// Event sink of type void which publishes the state, connect it to a work tick.
+	auto& publish_tick() { return publish_sink; }
+
+private:
+	ipc::seqlock_slot<data_t> slot;
+	event_sink<void> publish_sink;
+};
+
+/**
+ * \brief State source which provides state published by another process.
+ *
+ * Opens the shared memory object created by a shm_state_sink.
+ * Every pull reads the latest published state without locking,
+ * until the first state is published the initial value is provided.
+ *
+ * shm_state_source fulfills passive_source.
+ * \tparam data_t type of state, needs to be trivially copyable.
+ * \ingroup ports
+ */
+template <class data_t>
+class shm_state_source
+{
+public:
+	/**
+	 * \throws std::system_error if shared memory object name does not exist.
+	 * \throws std::runtime_error if it does not contain a state of data_t.
+	 */
+	explicit shm_state_source(const std::string& name, const data_t& initial_value = data_t{})
+		: slot(ipc::seqlock_slot<data_t>::open(name))
+		, last(initial_value)
+	{
+	}
+
+	data_t operator()()
+	{
+		slot.load(last);
+		return last;
+	}
+
+private:
+	ipc::seqlock_slot<data_t> slot;
+	data_t last;
+};
+
+} // namespace pure
+
+template <class T> struct is_active_source<pure::shm_event_source<T>> : std::true_type {};
+template <class T> struct is_active_sink<pure::shm_state_sink<T>> : std::true_type {};
+
+} // namespace fc
+
+#endif /* FLEXCORE_PURE_SHM_PORTS_HPP_ */
@@ -12,18 +12,50 @@ namespace fc
 
 namespace chr = std::chrono;
 
-std::atomic<virtual_clock::system::time_point>
-		virtual_clock::system::current_time{(
-				virtual_clock::system::time_point(
-						virtual_clock::system::duration::zero()))};
-std::atomic<virtual_clock::steady::time_point>
-		virtual_clock::steady::current_time{(
-				virtual_clock::steady::time_point(
-						virtual_clock::steady::duration::zero()))};
+namespace
+{
+/// context bound to this thread by clock_context::scope
+clock_context*& bound_context() noexcept
+{
+	thread_local clock_context* context = nullptr;
+	return context;
+}
+}
+
+std::shared_ptr<clock_context> clock_context::process_context()
+{
+	static const auto context = std::make_shared<clock_context>();
+	return context;
+}
+
+clock_context& clock_context::current() noexcept
+{
+	if (auto* context = bound_context())
+		return *context;
+	static clock_context& process = *process_context();
+	return process;
+}
+
+void clock_context::advance(virtual_clock::duration d) noexcept
+{
+	steady_time.store(steady_time.load() + d);
+	system_time.store(system_time.load() + d);
+}
+
+clock_context::scope::scope(clock_context& context) noexcept
+	: previous(bound_context())
+{
+	bound_context() = &context;
+}
+
+clock_context::scope::~scope()
+{
+	bound_context() = previous;
+}
 
 virtual_clock::system::time_point virtual_clock::system::now() noexcept
 {
-	return current_time.load();
+	return clock_context::current().system_now();
 }
 
 std::time_t virtual_clock::system::to_time_t(const time_point& t)
@@ -41,26 +73,9 @@ virtual_clock::system::time_point virtual_clock::system::from_time_t(std::time_t
 	return chr::time_point_cast<virtual_clock::duration>(tmp);
 }
 
-void virtual_clock::system::advance(duration d) noexcept
-{
-	const auto tmp = current_time.load();
-	current_time.store(tmp + d);
-}
-
-void virtual_clock::system::set_time(time_point r) noexcept
-{
-	current_time.store(r);
-}
-
 virtual_clock::steady::time_point virtual_clock::steady::now() noexcept
 {
-	return current_time.load();
-}
-
-void virtual_clock::steady::advance(duration d) noexcept
-{
-	const auto tmp = current_time.load();
-	current_time.store(tmp + d);
+	return clock_context::current().steady_now();
 }
 
 }  //namespace fc
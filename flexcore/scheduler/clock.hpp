@@ -10,13 +10,12 @@
 
 #include <atomic>
 #include <chrono>
+#include <ctime>
+#include <memory>
 
 namespace fc
 {
 
-//forward declaration for friend declartations in virtual_clock
-template<class T> class master_clock;
-
 /**
  * \brief  Wall clock for measurements of system time.
  * Timings in Solutions should pretty much always use virtual clock.
@@ -73,14 +72,6 @@ struct virtual_clock
 		static std::time_t to_time_t( const time_point& t );
 		static time_point from_time_t( std::time_t t );
 
-		template<class T>
-		friend class master_clock;
-	private:
-
-		static void advance(duration d) noexcept;
-		static void set_time(time_point r) noexcept;
-
-		static std::atomic<time_point> current_time;
 	};
 
 	/**
@@ -103,19 +94,69 @@ struct virtual_clock
 		 * \post if now is called twice with results t1 and t2, t2 >= t1 holds.
 		 */
 		static time_point now() noexcept;
+	};
+};
 
-	private:
-		template<class T>
-		friend class master_clock;
+/**
+ * \brief holds the time of the virtual clocks of a single simulation.
+ *
+ * virtual_clock::system::now and virtual_clock::steady::now return the time
+ * of the clock_context bound to the calling thread,
+ * or the time of the process_context, if no context is bound.
+ * cycle_control binds its context to the threads executing its tasks,
+ * thus several simulations with their own contexts can run in parallel in one process.
+ */
+class clock_context
+{
+public:
+	clock_context() = default;
+	clock_context(const clock_context&) = delete;
+	clock_context& operator=(const clock_context&) = delete;
+
+	/// returns the context used by threads without bound context.
+	static std::shared_ptr<clock_context> process_context();
+	/// returns the context bound to the calling thread, the process_context if there is none.
+	static clock_context& current() noexcept;
+
+	virtual_clock::steady::time_point steady_now() const noexcept
+	{
+		return steady_time.load();
+	}
+	virtual_clock::system::time_point system_now() const noexcept
+	{
+		return system_time.load();
+	}
 
-		static void advance(duration d) noexcept;
+	/// advances both clocks by d.
+	void advance(virtual_clock::duration d) noexcept;
+	/// sets the time of the system clock, the steady clock has only relative timings.
+	void set_time(virtual_clock::system::time_point t) noexcept { system_time.store(t); }
+
+	/**
+	 * \brief binds a context to the calling thread for its lifetime.
+	 * The context bound before is restored on destruction.
+	 */
+	class scope
+	{
+	public:
+		explicit scope(clock_context& context) noexcept;
+		~scope();
+		scope(const scope&) = delete;
+		scope& operator=(const scope&) = delete;
 
-		static std::atomic<time_point> current_time;
+	private:
+		clock_context* previous;
 	};
+
+private:
+	std::atomic<virtual_clock::steady::time_point> steady_time{
+			virtual_clock::steady::time_point(virtual_clock::duration::zero())};
+	std::atomic<virtual_clock::system::time_point> system_time{
+			virtual_clock::system::time_point(virtual_clock::duration::zero())};
 };
 
 /**
- * \brief controls the time of the two virtual clocks.
+ * \brief controls the time of the two virtual clocks of the current clock_context.
  *
  * \tparam period_t the period of a single tick. Is the smallest duration possible.
  */
@@ -135,22 +176,14 @@ public:
 	 */
 	static void advance() noexcept
 	{
-		steady_clock.advance(
-				std::chrono::duration_cast<virtual_clock::steady::duration>
-				(duration(1)));
-		system_clock.advance(
-				std::chrono::duration_cast<virtual_clock::system::duration>
-				(duration(1)));
+		clock_context::current().advance(
+				std::chrono::duration_cast<virtual_clock::duration>(duration(1)));
 	}
 	static void set_time(virtual_clock::system::time_point r) noexcept
 	{
-		system_clock.set_time(r);
+		clock_context::current().set_time(r);
 		//do not set time of steady clock, as it has only relative timings.
 	}
-
-private:
-	static virtual_clock::steady steady_clock;
-	static virtual_clock::system system_clock;
 };
 
 }  //namespace fc
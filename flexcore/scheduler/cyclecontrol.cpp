@@ -1,14 +1,43 @@
 #include <flexcore/scheduler/cyclecontrol.hpp>
 
 #include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <initializer_list>
+#include <limits>
 #include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <time.h>
 
 namespace fc
 {
 namespace thread
 {
 
-using clock = master_clock<std::centi>;
+
+namespace
+{
+/**
+ * sleeps until deadline, which is measured by wall_clock::steady.
+ * On linux std::chrono::steady_clock is CLOCK_MONOTONIC,
+ * thus the deadline can be passed as absolute time to clock_nanosleep,
+ * which does not accumulate the error of converting it to a relative time.
+ */
+void sleep_until_absolute(wall_clock::steady::time_point deadline)
+{
+	const auto since_epoch = deadline.time_since_epoch();
+	const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(since_epoch);
+	timespec wake{};
+	wake.tv_sec = static_cast<time_t>(seconds.count());
+	wake.tv_nsec = static_cast<long>(
+			std::chrono::duration_cast<std::chrono::nanoseconds>(since_epoch - seconds).count());
+	// the deadline is absolute, thus the sleep can just be repeated if interrupted by a signal.
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake, nullptr) == EINTR)
+		;
+}
+}
 constexpr wall_clock::steady::duration cycle_control::min_tick_length;
 constexpr virtual_clock::steady::duration cycle_control::fast_tick;
 constexpr virtual_clock::steady::duration cycle_control::medium_tick;
@@ -34,6 +63,8 @@ void cycle_control::start()
 	// give the main thread some actual work to do (execute infinite main loop)
 	main_loop_thread = std::thread{
 		[&, this](){
+			profiler::get().name_thread("main loop");
+			const clock_context::scope bind_clocks{*clocks_};
 			main_loop_->arm();
 			while(keep_working.load())
 				main_loop_->loop_body([this](){ work(); });
@@ -46,7 +77,15 @@ void cycle_control::stop()
 	keep_working.store(false);
 	if (main_loop_thread.joinable())
 		main_loop_thread.join();
-	// wait for scheduled tasks to finish
+	wait_for_all_tasks();
+	running = false;
+	//check post condition
+	assert(!keep_working.load());
+	assert(!running);
+}
+
+void cycle_control::wait_for_all_tasks()
+{
 	auto wait_or_throw = [this](auto& task_vector)
 	{
 		for (auto& t : task_vector.tasks)
@@ -56,10 +95,6 @@ void cycle_control::stop()
 	wait_or_throw(tasks_fast);
 	wait_or_throw(tasks_medium);
 	wait_or_throw(tasks_slow);
-	running = false;
-	//check post condition
-	assert(!keep_working.load());
-	assert(!running);
 }
 
 bool cycle_control::store_exception(periodic_task&)
@@ -72,15 +107,16 @@ bool cycle_control::store_exception(periodic_task&)
 
 void cycle_control::work()
 {
-	auto now = virtual_clock::steady::now().time_since_epoch();
+	const profile_scope scope{trace_category::cycle, cycle_trace_name};
+	const clock_context::scope bind_clocks{*clocks_};
+	auto now = clocks_->steady_now().time_since_epoch();
+	if (automatic_phases.load() && now % slow_tick == virtual_clock::duration::zero())
+		redistribute_phases();
 	auto run_if_due = [this, now](auto& task_vector)
 	{
-		if (now % task_vector.tick == virtual_clock::duration::zero())
-			if (!run_periodic_tasks(task_vector))
-				return false;
-		return true;
+		return run_periodic_tasks(task_vector, now % task_vector.tick);
 	};
-	clock::advance();
+	clocks_->advance(min_tick_length);
 	if (!run_if_due(tasks_fast)) return;
 	if (!run_if_due(tasks_medium)) return;
 	if (!run_if_due(tasks_slow)) return;
@@ -88,21 +124,19 @@ void cycle_control::work()
 
 void cycle_control::wait_for_current_tasks()
 {
-	auto now = virtual_clock::steady::now().time_since_epoch();
+	auto now = clocks_->steady_now().time_since_epoch();
 	auto wait_for_tasks = [this, now](auto& task_vector)
 	{
-		if (now % task_vector.tick == virtual_clock::duration::zero())
-		{
-			for (auto& task : task_vector.tasks)
-				if (!task.wait_until_done(task_vector.tick))
+		const auto phase = now % task_vector.tick;
+		for (auto& task : task_vector.tasks)
+			if (task.phase() == phase && !task.wait_until_done(task_vector.tick))
+			{
+				if (!timeout_callback(task))
 				{
-					if (!timeout_callback(task))
-					{
-						keep_working.store(false);
-						return false;
-					}
+					keep_working.store(false);
+					return false;
 				}
-		}
+			}
 		return true;
 	};
 	if (!wait_for_tasks(tasks_slow)) return;
@@ -116,11 +150,13 @@ cycle_control::~cycle_control()
 	assert(!running);
 }
 
-bool cycle_control::run_periodic_tasks(tick_task_pair& tasks)
+bool cycle_control::run_periodic_tasks(tick_task_pair& tasks, virtual_clock::duration phase)
 {
 	assert(tasks.done_tasks.empty());
 	for (auto& task : tasks.tasks)
 	{
+		if (task.phase() != phase || task.skip_moved_run())
+			continue;
 		if (!task.done())
 		{
 			if (!timeout_callback(task))
@@ -138,23 +174,62 @@ bool cycle_control::run_periodic_tasks(tick_task_pair& tasks)
 	{
 		periodic_task& task = task_ref.get();
 		assert(task.done());
+		task.apply_phase_move();
 		task.set_work_to_do(true);
 		task.send_switch_tick();
 	}
+	// the tasks of a tick should be done before the next tick of the same rate.
+	const auto due = wall_clock::steady::now() + tasks.tick;
 	for (auto& task_ref : tasks.done_tasks)
 	{
-		periodic_task& task = task_ref.get();
-		scheduler_->add_task([&task] { task(); });
+		// regions which are not triggered keep their switch tick, but skip their work.
+		if (task_ref.get().has_pending_work())
+			schedule_slice(task_ref.get(), due);
+		else
+			task_ref.get().skip_cycle();
 	}
 	tasks.done_tasks.clear();
 	return true;
 }
 
-void cycle_control::add_task(periodic_task task, virtual_clock::duration tick_rate)
+void cycle_control::schedule_slice(periodic_task& task, wall_clock::steady::time_point due)
+{
+	// unfinished tasks are added again with their original deadline,
+	// thus tasks with an earlier deadline are executed in between.
+	scheduler_->add_task([this, &task, due]()
+			{
+				const clock_context::scope bind_clocks{*clocks_};
+				if (task.run_slice() == slice_result::yield)
+					schedule_slice(task, due);
+				else
+					schedule_parallel_work(task, due);
+			}, due - wall_clock::steady::now());
+}
+
+void cycle_control::schedule_parallel_work(periodic_task& task, wall_clock::steady::time_point due)
+{
+	// all groups but the first are handed to other threads, the first continues on this one.
+	const auto groups = task.nr_of_parallel_groups();
+	for (std::size_t i = 1; i < groups; ++i)
+		scheduler_->add_task([this, &task, i]()
+				{
+					const clock_context::scope bind_clocks{*clocks_};
+					task.run_parallel_work(i);
+				}, due - wall_clock::steady::now());
+	if (groups != 0)
+		task.run_parallel_work(0);
+}
+
+void cycle_control::add_task(periodic_task task, virtual_clock::duration tick_rate,
+		virtual_clock::duration phase)
 {
 	if (running)
 		throw std::runtime_error{"Worker threads are already running"};
+	if (phase < virtual_clock::duration::zero() || phase >= tick_rate
+			|| phase % min_tick_length != virtual_clock::duration::zero())
+		throw std::invalid_argument{"Phase is no multiple of min_tick_length within tick_rate"};
 
+	task.set_phase(phase);
 	if (tick_rate == slow_tick)
 		tasks_slow.tasks.emplace_back(std::move(task));
 	else if (tick_rate == medium_tick)
@@ -165,6 +240,121 @@ void cycle_control::add_task(periodic_task task, virtual_clock::duration tick_ra
 		throw std::invalid_argument{"Unsupported tick_rate"};
 }
 
+void cycle_control::distribute_phases()
+{
+	assert(!running);
+	const auto phases = balanced_phases();
+	auto phase = phases.begin();
+	for (auto* bucket : {&tasks_medium, &tasks_slow})
+		for (auto& task : bucket->tasks)
+			task.set_phase(*phase++);
+}
+
+void cycle_control::redistribute_phases()
+{
+	const auto phases = balanced_phases();
+	std::vector<virtual_clock::duration> current;
+	for (auto* bucket : {&tasks_medium, &tasks_slow})
+		for (auto& task : bucket->tasks)
+			current.push_back(task.target_phase());
+
+	// every move stretches an interval of the task, thus small improvements are not worth it.
+	const auto current_peak = peak_load(current);
+	const auto new_peak = peak_load(phases);
+	const bool improves = new_peak.first * 10 < current_peak.first * 9
+			|| (new_peak.first == current_peak.first && new_peak.second < current_peak.second);
+	if (!improves)
+		return;
+
+	auto phase = phases.begin();
+	for (auto* bucket : {&tasks_medium, &tasks_slow})
+		for (auto& task : bucket->tasks)
+			task.move_to_phase(*phase++);
+}
+
+std::pair<wall_clock::steady::duration, std::size_t> cycle_control::peak_load(
+		const std::vector<virtual_clock::duration>& phases)
+{
+	using duration = wall_clock::steady::duration;
+	const auto cycles = static_cast<std::size_t>(slow_tick / min_tick_length);
+	std::vector<duration> load(cycles);
+	std::vector<std::size_t> count(cycles);
+	auto phase = phases.begin();
+	for (auto* bucket : {&tasks_medium, &tasks_slow})
+	{
+		const auto nr_of_phases = static_cast<std::size_t>(bucket->tick / min_tick_length);
+		for (auto& task : bucket->tasks)
+		{
+			const auto time = task.execution_time();
+			for (auto cycle = static_cast<std::size_t>(*phase++ / min_tick_length);
+					cycle < cycles; cycle += nr_of_phases)
+			{
+				load[cycle] += time;
+				++count[cycle];
+			}
+		}
+	}
+	return {*std::max_element(load.begin(), load.end()),
+			*std::max_element(count.begin(), count.end())};
+}
+
+std::vector<virtual_clock::duration> cycle_control::balanced_phases()
+{
+	using duration = wall_clock::steady::duration;
+	// peak load and number of tasks of every cycle within a slow tick.
+	const auto cycles = static_cast<std::size_t>(slow_tick / min_tick_length);
+	std::vector<duration> load(cycles);
+	std::vector<std::size_t> count(cycles);
+	std::vector<virtual_clock::duration> result;
+
+	const auto assign = [&load, &count, &result, cycles](tick_task_pair& bucket)
+	{
+		const auto phases = static_cast<std::size_t>(bucket.tick / min_tick_length);
+		const auto first = result.size();
+		result.resize(first + bucket.tasks.size());
+		std::vector<std::pair<duration, std::size_t>> order;
+		for (std::size_t i = 0; i != bucket.tasks.size(); ++i)
+			order.emplace_back(bucket.tasks[i].execution_time(), i);
+		std::stable_sort(order.begin(), order.end(),
+				[](const auto& lhs, const auto& rhs) { return lhs.first > rhs.first; });
+
+		// longest task first to the phase whose cycles have the lowest peak,
+		// the number of tasks breaks ties, to spread tasks which have not been measured yet.
+		for (const auto& entry : order)
+		{
+			std::size_t best_phase = 0;
+			auto best_peak = duration::max();
+			auto best_count = std::numeric_limits<std::size_t>::max();
+			for (std::size_t phase = 0; phase != phases; ++phase)
+			{
+				auto peak = duration::zero();
+				std::size_t peak_count = 0;
+				for (auto cycle = phase; cycle < cycles; cycle += phases)
+				{
+					peak = std::max(peak, load[cycle]);
+					peak_count = std::max(peak_count, count[cycle]);
+				}
+				if (peak < best_peak || (peak == best_peak && peak_count < best_count))
+				{
+					best_phase = phase;
+					best_peak = peak;
+					best_count = peak_count;
+				}
+			}
+			for (auto cycle = best_phase; cycle < cycles; cycle += phases)
+			{
+				load[cycle] += entry.first;
+				++count[cycle];
+			}
+			result[first + entry.second] =
+					static_cast<virtual_clock::duration::rep>(best_phase) * min_tick_length;
+		}
+	};
+	assign(tasks_medium);
+	assign(tasks_slow);
+	return result;
+}
+
 std::exception_ptr cycle_control::last_exception()
 {
 	std::lock_guard<std::mutex> lock(task_exception_mutex);
@@ -182,15 +372,130 @@ void cycle_control::set_main_loop(const std::shared_ptr<main_loop>& loop)
 	assert(loop);
 	main_loop_ = loop;
 	main_loop_->wait_for_current_tasks = [this](){ wait_for_current_tasks(); };
+	main_loop_->skip_tick = [this](){ skip_tick(); };
+}
+
+void cycle_control::skip_tick()
+{
+	clocks_->advance(min_tick_length);
+}
+
+void cycle_control::set_clocks(std::shared_ptr<clock_context> context)
+{
+	assert(context);
+	assert(!running);
+	clocks_ = std::move(context);
+}
+
+namespace detail
+{
+bool overrun_guard::after_work(wall_clock::steady::time_point& epoch,
+		wall_clock::steady::time_point now, const std::function<void(void)>& skip_tick)
+{
+	if (now <= epoch)
+		return false;
+
+	const auto lateness = now - epoch;
+	std::lock_guard<std::mutex> lock(statistics_mutex);
+	++statistics_.overruns;
+	statistics_.max_lateness = std::max(statistics_.max_lateness, lateness);
+	switch (policy)
+	{
+	case overrun_policy::catch_up:
+		break;
+	case overrun_policy::skip:
+	{
+		// ticks which passed completely are skipped, the current one runs late.
+		const auto missed = static_cast<std::size_t>(lateness / cycle_control::min_tick_length);
+		for (std::size_t i = 0; i != missed; ++i)
+			if (skip_tick)
+				skip_tick();
+		epoch += missed * cycle_control::min_tick_length;
+		statistics_.skipped_ticks += missed;
+		break;
+	}
+	case overrun_policy::slip:
+		epoch = now;
+		statistics_.slipped += lateness;
+		break;
+	}
+	return true;
+}
+
+overrun_statistics overrun_guard::statistics() const
+{
+	std::lock_guard<std::mutex> lock(statistics_mutex);
+	return statistics_;
+}
+
+void overrun_guard::reset()
+{
+	std::lock_guard<std::mutex> lock(statistics_mutex);
+	statistics_ = overrun_statistics{};
+}
+}
+
+void realtime_main_loop::arm()
+{
+	epoch = wall_clock::steady::now();
+	overruns.reset();
 }
 
 void realtime_main_loop::loop_body(const std::function<void(void)>& work)
 {
 	epoch += cycle_control::min_tick_length;
 	work();
+	overruns.after_work(epoch, wall_clock::steady::now(), skip_tick);
 	std::this_thread::sleep_until(epoch);
 }
 
+low_jitter_main_loop::low_jitter_main_loop(wall_clock::steady::duration spin_margin,
+		overrun_policy policy)
+	: spin_margin(spin_margin)
+	, overruns(policy)
+{
+	assert(spin_margin >= wall_clock::steady::duration::zero());
+}
+
+void low_jitter_main_loop::loop_body(const std::function<void(void)>& work)
+{
+	epoch += cycle_control::min_tick_length;
+	work();
+	if (overruns.after_work(epoch, wall_clock::steady::now(), skip_tick))
+		return;
+
+	sleep_until_absolute(epoch - spin_margin);
+	auto now = wall_clock::steady::now();
+	while (now < epoch)
+		now = wall_clock::steady::now();
+
+	const auto error = now - epoch;
+	std::lock_guard<std::mutex> lock(statistics_mutex);
+	++statistics.ticks;
+	statistics.last = error;
+	statistics.max = std::max(statistics.max, error);
+	statistics.sum += error;
+}
+
+void low_jitter_main_loop::arm()
+{
+	epoch = wall_clock::steady::now();
+	reset_wakeup_errors();
+	overruns.reset();
+}
+
+wakeup_statistics low_jitter_main_loop::wakeup_errors() const
+{
+	std::lock_guard<std::mutex> lock(statistics_mutex);
+	return statistics;
+}
+
+void low_jitter_main_loop::reset_wakeup_errors()
+{
+	std::lock_guard<std::mutex> lock(statistics_mutex);
+	statistics = wakeup_statistics{};
+}
+
 void timewarp_main_loop::loop_body(const std::function<void(void)>& work)
 {
 	wait_for_current_tasks();
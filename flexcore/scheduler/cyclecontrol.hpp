@@ -5,13 +5,17 @@
 #include <flexcore/scheduler/scheduler.hpp>
 #include <flexcore/scheduler/parallelregion.hpp>
 #include <flexcore/pure/event_sources.hpp>
+#include <flexcore/utils/profiling/profiler.hpp>
 
 #include <cassert>
+#include <chrono>
 #include <condition_variable>
+#include <cstddef>
 #include <deque>
 #include <mutex>
 #include <memory>
 #include <thread>
+#include <utility>
 #include <vector>
 
 namespace fc
@@ -43,19 +47,26 @@ struct periodic_task final
 	explicit periodic_task(std::function<void(void)> job)
 		: work_to_do(false)
 		, sync(std::make_unique<detail::condition_pair>())
-		, work(std::move(job))
+		, work(single_slice(std::move(job)))
 		, work_start(wall_clock::steady::now())
 		, region(nullptr)
+		, trace_name(profiler::get().intern("periodic_task"))
 	{
 		assert(work);
 	}
-	/// Construct a periodic task executes work within a region
+	/**
+	 * \brief Construct a periodic task executes work within a region
+	 *
+	 * The work tick of the region and its sliced work are executed in slices,
+	 * see tick_controller::add_sliced_work.
+	 */
 	explicit periodic_task(const std::shared_ptr<parallel_region>& r) :
 				work_to_do(false),
 				sync(std::make_unique<detail::condition_pair>()),
-				work(r->ticks.in_work()),
+				work([ticks = &r->ticks]() { return ticks->work_slice(); }),
 				work_start(wall_clock::steady::now()),
-				region(r)
+				region(r),
+				trace_name(profiler::get().intern(r->get_id().key))
 	{
 		assert(r != nullptr);
 		assert(work);
@@ -80,6 +91,53 @@ struct periodic_task final
 			sync->cv.notify_all();
 	}
 
+	/**
+	 * \brief offset of the task within its tick.
+	 * The task is executed on cycles, where the virtual time modulo its tick equals the phase.
+	 */
+	virtual_clock::duration phase() const { return phase_; }
+	void set_phase(virtual_clock::duration phase)
+	{
+		phase_ = phase;
+		next_phase_ = phase;
+		skip_next_run = false;
+	}
+
+	/**
+	 * \brief moves the task to phase without running it more often than its tick.
+	 *
+	 * The phase changes after the next run of the task on its current phase
+	 * and the first cycle of the new phase is skipped.
+	 * Thus the interval between two runs is never shorter than the tick
+	 * and once up to twice the tick.
+	 */
+	void move_to_phase(virtual_clock::duration phase) { next_phase_ = phase; }
+	/// returns the phase of the task after its pending move, see move_to_phase.
+	virtual_clock::duration target_phase() const { return next_phase_; }
+
+	/// called on cycles of its phase, returns true if the run is skipped after a move.
+	bool skip_moved_run()
+	{
+		const bool skip = skip_next_run;
+		skip_next_run = false;
+		return skip;
+	}
+	/// called on runs of the task, applies the pending move.
+	void apply_phase_move()
+	{
+		if (next_phase_ == phase_)
+			return;
+		phase_ = next_phase_;
+		skip_next_run = true;
+	}
+
+	/// returns the moving average of the time the work of a cycle took, zero if never executed.
+	wall_clock::steady::duration execution_time()
+	{
+		std::lock_guard<std::mutex> lock(sync->mtx);
+		return execution_time_;
+	}
+
 	/** \brief waits for this task to be done, but only until the provided timeout.
 	 * \return true if the task is done.
 	 */
@@ -97,25 +155,162 @@ struct periodic_task final
 	void send_switch_tick()
 	{
 		if (region)
+		{
+			const profile_scope scope{trace_category::switch_tick, trace_name};
 			region->ticks.switch_buffers();
+		}
 	}
 
+	/// executes all work of this cycle.
 	void operator()()
 	{
-		work_start = wall_clock::steady::now();
-		work();
+		while (run_slice() == slice_result::yield)
+			;
+		for (std::size_t i = 0; i != nr_of_parallel_groups(); ++i)
+			run_parallel_work(i);
+	}
+
+	/**
+	 * \brief checks if the work of this cycle has to be executed.
+	 * Tasks without region always have work, see tick_controller::set_run_when_triggered.
+	 */
+	bool has_pending_work() { return !region || region->ticks.has_pending_work(); }
+
+	/// marks the work of this cycle as done without executing it.
+	void skip_cycle()
+	{
+		{
+			std::lock_guard<std::mutex> lock(sync->mtx);
+			++skipped_cycles_;
+		}
 		set_work_to_do(false);
 	}
+
+	/// returns the number of cycles skipped, because the region was not triggered.
+	std::size_t skipped_cycles()
+	{
+		std::lock_guard<std::mutex> lock(sync->mtx);
+		return skipped_cycles_;
+	}
+
+	/// returns the number of groups of parallel work of the region, zero without region.
+	std::size_t nr_of_parallel_groups() const
+	{
+		return region ? region->ticks.nr_of_parallel_groups() : 0;
+	}
+
+	/**
+	 * \brief executes a single group of parallel work of the region.
+	 *
+	 * Groups can be executed in parallel after run_slice returned slice_result::done.
+	 * The work of the cycle is complete, once all groups have been executed.
+	 * \pre index < nr_of_parallel_groups()
+	 * \returns true if this was the last group of the cycle.
+	 */
+	bool run_parallel_work(std::size_t index)
+	{
+		assert(index < nr_of_parallel_groups());
+		const auto group_start = wall_clock::steady::now();
+		{
+			const profile_scope scope{trace_category::work_tick, trace_name};
+			region->ticks.parallel_work(index);
+		}
+		const auto group_time = wall_clock::steady::now() - group_start;
+		{
+			std::lock_guard<std::mutex> lock(sync->mtx);
+			work_time += group_time;
+			assert(pending_groups > 0);
+			if (--pending_groups != 0)
+				return false;
+		}
+		finish_cycle();
+		return true;
+	}
+
+	/**
+	 * \brief executes the next slice of the work of this cycle.
+	 * \returns slice_result::done if the work of this cycle is complete.
+	 */
+	slice_result run_slice()
+	{
+		const auto slice_start = wall_clock::steady::now();
+		if (!started)
+		{
+			work_start = slice_start;
+			work_time = wall_clock::steady::duration::zero();
+			started = true;
+		}
+		slice_result result = slice_result::done;
+		{
+			const profile_scope scope{
+					region ? trace_category::work_tick : trace_category::task, trace_name};
+			result = work();
+		}
+		work_time += wall_clock::steady::now() - slice_start;
+		if (result == slice_result::done)
+		{
+			started = false;
+			const auto groups = nr_of_parallel_groups();
+			if (groups == 0)
+				finish_cycle();
+			else
+			{
+				std::lock_guard<std::mutex> lock(sync->mtx);
+				pending_groups = groups;
+			}
+		}
+		return result;
+	}
 private:
+	/// updates the execution time and marks the work of this cycle as done.
+	void finish_cycle()
+	{
+		{
+			std::lock_guard<std::mutex> lock(sync->mtx);
+			execution_time_ = execution_time_ == wall_clock::steady::duration::zero()
+					? work_time
+					: (execution_time_ * 7 + work_time) / 8;
+		}
+		set_work_to_do(false);
+	}
+
+	/// wraps a job, which is not sliced, in a single slice.
+	static std::function<slice_result(void)> single_slice(std::function<void(void)> job)
+	{
+		assert(job);
+		return [job = std::move(job)]()
+		{
+			job();
+			return slice_result::done;
+		};
+	}
+
 	/// flag to check if work has already been executed this cycle.
 	bool work_to_do;
 	std::unique_ptr<detail::condition_pair> sync;
-	/// work to be done every cycle
-	std::function<void(void)> work;
+	/// work to be done every cycle, executed in slices
+	std::function<slice_result(void)> work;
+	/// true if the first slice of this cycle has been executed.
+	bool started = false;
+	/// time spent in slices and parallel work of the current cycle, guarded by sync->mtx
+	wall_clock::steady::duration work_time{};
+	/// number of groups of parallel work not yet executed in this cycle, guarded by sync->mtx
+	std::size_t pending_groups = 0;
+	/// number of cycles skipped by skip_cycle, guarded by sync->mtx
+	std::size_t skipped_cycles_ = 0;
+	/// moving average of work_time of complete cycles, guarded by sync->mtx
+	wall_clock::steady::duration execution_time_{};
+	virtual_clock::duration phase_{};
+	/// phase after the next run, see move_to_phase
+	virtual_clock::duration next_phase_{};
+	/// true if the next cycle of phase_ is skipped to keep the interval after a move.
+	bool skip_next_run = false;
 	/// start time of most recent work cycle
 	wall_clock::steady::time_point work_start;
 
 	std::shared_ptr<parallel_region> region;
+	/// name of the task in traces of the profiler, the name of its region if it has one.
+	profiler::name_id trace_name;
 };
 
 ///Abstract Base class for all main lopp classes.
@@ -128,7 +323,64 @@ public:
 	virtual void arm() = 0;
 
 	std::function<void(void)> wait_for_current_tasks{};
+	/// advances virtual time by a single tick without executing tasks.
+	std::function<void(void)> skip_tick{};
+};
+
+/// What realtime main loops do after the work of a tick took longer than the tick.
+enum class overrun_policy
+{
+	/// run the missed ticks back to back until the loop caught up with wall time.
+	catch_up,
+	/**
+	 * skip ticks which passed completely and advance virtual time for them
+	 * without executing tasks, tasks due in skipped ticks run on their next tick.
+	 */
+	skip,
+	/// move the start of the next tick to now, virtual time falls behind wall time.
+	slip
+};
+
+/// Counts overruns of a realtime main loop.
+struct overrun_statistics
+{
+	/// number of ticks whose work ended after the end of the tick
+	std::size_t overruns = 0;
+	/// number of ticks skipped by overrun_policy::skip
+	std::size_t skipped_ticks = 0;
+	/// total time the start of ticks was moved by overrun_policy::slip
+	wall_clock::steady::duration slipped{};
+	/// maximum time the work of a tick ended after the end of the tick
+	wall_clock::steady::duration max_lateness{};
+};
+
+namespace detail
+{
+/// applies an overrun_policy to the epoch of a realtime main loop and counts overruns.
+class overrun_guard
+{
+public:
+	explicit overrun_guard(overrun_policy policy) : policy(policy) {}
+
+	/**
+	 * \brief checks if the tick ending at epoch overran and applies the policy.
+	 * \param epoch end of the current tick, moved by the policy.
+	 * \param now time the work of the current tick ended.
+	 * \param skip_tick advances virtual time by a tick, may be empty.
+	 * \returns true if the tick overran.
+	 */
+	bool after_work(wall_clock::steady::time_point& epoch, wall_clock::steady::time_point now,
+			const std::function<void(void)>& skip_tick);
+
+	overrun_statistics statistics() const;
+	void reset();
+
+private:
+	const overrun_policy policy;
+	mutable std::mutex statistics_mutex{};
+	overrun_statistics statistics_{};
 };
+}
 
 /**
  * \brief Main Loop which runs as fast as possible
@@ -147,12 +399,76 @@ public:
 class realtime_main_loop final : public main_loop
 {
 public:
+	/// \param policy what to do if the work of a tick takes longer than the tick
+	explicit realtime_main_loop(overrun_policy policy = overrun_policy::catch_up)
+		: overruns(policy)
+	{
+	}
+
 	void loop_body(const std::function<void(void)>& work) override;
 
-	void arm() override { epoch = wall_clock::steady::now(); };
+	void arm() override;
+
+	/// returns overruns since arm or reset_overruns.
+	overrun_statistics overrun_counts() const { return overruns.statistics(); }
+	void reset_overruns() { overruns.reset(); }
+
+private:
+	wall_clock::steady::time_point epoch{wall_clock::steady::now()};
+	detail::overrun_guard overruns;
+};
+
+/// Wake-up errors of a main loop, the time it woke up later than the end of its ticks.
+struct wakeup_statistics
+{
+	/// number of ticks measured
+	std::size_t ticks = 0;
+	/// error of the most recent tick
+	wall_clock::steady::duration last{};
+	wall_clock::steady::duration max{};
+	/// sum of the errors of all ticks, divide by ticks for the mean error.
+	wall_clock::steady::duration sum{};
+};
+
+/**
+ * \brief Main Loop which runs in realtime with low jitter.
+ *
+ * Sleeps with an absolute deadline until spin_margin before the end of the tick
+ * and busy waits for the rest of it.
+ * This trades cpu time of the main loop thread for a precise wake-up,
+ * the spin_margin should be chosen slightly larger than the wake-up jitter of the system.
+ * The wake-up error of every tick is measured, see wakeup_errors.
+ */
+class low_jitter_main_loop final : public main_loop
+{
+public:
+	/**
+	 * \param spin_margin time before the end of a tick from which on the loop busy waits
+	 * \param policy what to do if the work of a tick takes longer than the tick
+	 * \pre spin_margin >= 0
+	 */
+	explicit low_jitter_main_loop(
+			wall_clock::steady::duration spin_margin = std::chrono::microseconds(200),
+			overrun_policy policy = overrun_policy::catch_up);
+
+	void loop_body(const std::function<void(void)>& work) override;
+
+	void arm() override;
+
+	/// returns wake-up errors since arm or reset_wakeup_errors, ticks which overran do not count.
+	wakeup_statistics wakeup_errors() const;
+	void reset_wakeup_errors();
+
+	/// returns overruns since arm or reset_overruns.
+	overrun_statistics overrun_counts() const { return overruns.statistics(); }
+	void reset_overruns() { overruns.reset(); }
 
 private:
+	wall_clock::steady::duration spin_margin;
 	wall_clock::steady::time_point epoch{wall_clock::steady::now()};
+	mutable std::mutex statistics_mutex{};
+	wakeup_statistics statistics{};
+	detail::overrun_guard overruns;
 };
 
 /**
@@ -223,6 +539,10 @@ public:
 
 	/// advances the clock by a single tick and executes all tasks for the cycle.
 	void work();
+	/// waits for tasks due in the next cycle to be done, as afap_main_loop does before work.
+	void wait_for_current_tasks();
+	/// waits for all tasks to be done, calls the timeout handler for tasks taking a slow tick.
+	void wait_for_all_tasks();
 
 	/**
 	 * \brief adds a new cyclic task with the given tick_rate.
@@ -230,10 +550,32 @@ public:
 	 * std::runtime_error exception will be thrown if an attempt is made to add a task to a running
 	 * cycle_control.
 	 *
+	 * \param phase offset of the task within its tick, see periodic_task::phase.
+	 * Tasks of the same tick_rate with different phases are executed on different cycles,
+	 * which spreads their load. Throws std::invalid_argument if phase is not
+	 * a multiple of min_tick_length smaller than tick_rate.
 	 * \pre cycle_control is not running
 	 * \post list of tasks for given tick_rate is not empty
 	 */
-	void add_task(periodic_task task, virtual_clock::duration tick_rate);
+	void add_task(periodic_task task, virtual_clock::duration tick_rate,
+			virtual_clock::duration phase = virtual_clock::duration::zero());
+
+	/**
+	 * \brief distributes tasks of medium and slow ticks across the phases of their ticks.
+	 *
+	 * Tasks are assigned longest measured execution time first
+	 * to the phase with the lowest peak load, thus load is spread evenly across cycles.
+	 * Overrides phases given to add_task.
+	 * \pre cycle_control is not running
+	 */
+	void distribute_phases();
+	/**
+	 * \brief if set, phases are distributed on the main loop at the start of every slow tick.
+	 *
+	 * Tasks are only moved if that reduces the peak load by at least a tenth,
+	 * as every move stretches one interval of the task, see periodic_task::move_to_phase.
+	 */
+	void set_automatic_phases(bool automatic) { automatic_phases.store(automatic); }
 	/// returns the number of currently scheduled tasks
 	size_t nr_of_tasks() const { return scheduler_->nr_of_waiting_tasks(); }
 
@@ -248,6 +590,22 @@ public:
 	 */
 	void set_main_loop(const std::shared_ptr<main_loop>& loop);
 
+	/// advances the clock by a single tick without executing tasks.
+	void skip_tick();
+
+	/**
+	 * \brief sets the clocks advanced by this cycle_control.
+	 *
+	 * The context is bound to the main loop thread and to all tasks,
+	 * thus virtual_clock returns its time within them.
+	 * By default this is the clock_context::process_context.
+	 * Give every cycle_control its own context to run independent simulations in parallel.
+	 * \pre context != nullptr
+	 * \pre cycle_control is not running
+	 */
+	void set_clocks(std::shared_ptr<clock_context> context);
+	clock_context& clocks() const { return *clocks_; }
+
 private:
 	struct tick_task_pair
 	{
@@ -256,19 +614,34 @@ private:
 		std::vector<std::reference_wrapper<periodic_task>> done_tasks{};
 	};
 
-	/// runs the tasks in this vector; returns false if any task is not done, true otherwise
-	bool run_periodic_tasks(tick_task_pair& tasks);
-	void wait_for_current_tasks();
+	/**
+	 * runs the tasks in this vector which have the given phase;
+	 * returns false if any task is not done, true otherwise
+	 */
+	bool run_periodic_tasks(tick_task_pair& tasks, virtual_clock::duration phase);
+	/// returns phases balancing the load, for tasks_medium followed by tasks_slow.
+	std::vector<virtual_clock::duration> balanced_phases();
+	/// returns highest load and number of tasks of any cycle, if tasks had the given phases.
+	std::pair<wall_clock::steady::duration, std::size_t> peak_load(
+			const std::vector<virtual_clock::duration>& phases);
+	/// moves running tasks to balanced phases, if that reduces the peak load enough.
+	void redistribute_phases();
+	/// adds the next slice of task to the scheduler, which is to be done until due.
+	void schedule_slice(periodic_task& task, wall_clock::steady::time_point due);
+	/// adds the groups of parallel work of task to the scheduler, joined by the last one done.
+	void schedule_parallel_work(periodic_task& task, wall_clock::steady::time_point due);
 
 	tick_task_pair tasks_slow{slow_tick};
 	tick_task_pair tasks_medium{medium_tick};
 	tick_task_pair tasks_fast{fast_tick};
 	std::unique_ptr<scheduler> scheduler_;
 	std::atomic<bool> keep_working{false};
+	std::atomic<bool> automatic_phases{false};
 	bool running = false;
 
 	std::shared_ptr<main_loop> main_loop_;
 	std::thread main_loop_thread;
+	std::shared_ptr<clock_context> clocks_ = clock_context::process_context();
 
 	//Thread exception handling
 	std::mutex task_exception_mutex;
@@ -279,6 +652,8 @@ private:
 	 */
 	std::function<bool(periodic_task&)> timeout_callback;
 	bool store_exception(periodic_task& task);
+
+	profiler::name_id cycle_trace_name = profiler::get().intern("cycle");
 };
 
 template <class TimeOutFun>
@@ -292,6 +667,7 @@ inline cycle_control::cycle_control(std::unique_ptr<scheduler> scheduler,
 	assert(main_loop_);
 	assert(timeout_callback);
 	main_loop_->wait_for_current_tasks = [this](){ wait_for_current_tasks(); };
+	main_loop_->skip_tick = [this](){ skip_tick(); };
 }
 
 } /* namespace thread */
@@ -10,8 +10,16 @@
 
 #include <flexcore/pure/event_sources.hpp>
 #include <flexcore/scheduler/clock.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <map>
 #include <string>
 #include <memory>
+#include <vector>
 
 namespace fc
 {
@@ -25,6 +33,15 @@ struct region_id
 
 bool operator==(const region_id& lhs, const region_id& rhs);
 
+/// Result of a single slice of work, which is executed in several slices.
+enum class slice_result
+{
+	/// work is not finished, the next slice is executed after other tasks had a chance to run.
+	yield,
+	/// work of the current tick is finished.
+	done
+};
+
 /**
  * \brief class providing the interface to cyclic ticks for nodes.
  */
@@ -41,6 +58,40 @@ public:
 	 */
 	pure::event_source<void>& work_tick() { return work; }
 
+	/**
+	 * \brief sends void event on the work tick, possibly in parallel to other groups.
+	 *
+	 * Handlers of the same group are executed in the order they were connected,
+	 * handlers of different groups may be executed in parallel on the scheduler
+	 * after work_tick and the sliced work of the region.
+	 * The work tick of the region is complete once all groups are done.
+	 * Thus only connect handlers of independent subgraphs to different groups,
+	 * which do not share state and are not connected within the region.
+	 * \see graph::independent_subgraphs to find independent subgraphs of a region.
+	 */
+	pure::event_source<void>& parallel_work_tick(std::size_t group)
+	{
+		auto& tick = parallel_ticks[group];
+		if (!tick)
+			tick = std::make_unique<pure::event_source<void>>();
+		return *tick;
+	}
+
+	/// returns the number of groups connected to parallel_work_tick.
+	std::size_t nr_of_parallel_groups() const { return parallel_ticks.size(); }
+
+	/**
+	 * \brief fires the parallel_work_tick of a single group.
+	 * \param index index of the group in ascending order of their keys.
+	 * \pre index < nr_of_parallel_groups()
+	 * \pre work_slice returned slice_result::done for the current tick.
+	 */
+	void parallel_work(std::size_t index)
+	{
+		assert(index < parallel_ticks.size());
+		std::next(parallel_ticks.begin(), index)->second->fire();
+	}
+
 	/**
 	 * \brief Buffers in region will be switched when method is called.
 	 * expects event with no payload (void).
@@ -51,10 +102,119 @@ public:
 	 * connect to scheduler.
 	 * expects event with no payload (void).
 	 */
-	auto in_work() { return [this](){ return work.fire(); };}
+	auto in_work()
+	{
+		return [this]()
+		{
+			while (work_slice() == slice_result::yield)
+				;
+			for (std::size_t i = 0; i != nr_of_parallel_groups(); ++i)
+				parallel_work(i);
+		};
+	}
+
+	/**
+	 * \brief adds work, which is executed in slices after the work tick.
+	 *
+	 * slice is called repeatedly on every work tick, until it returns slice_result::done.
+	 * Between two slices, the scheduler may execute tasks of other regions on the same thread.
+	 * Thus long work of slow regions does not block a thread for fast regions,
+	 * as long as it keeps its progress between slices and yields regularly.
+	 * \pre slice is not empty
+	 */
+	void add_sliced_work(std::function<slice_result(void)> slice)
+	{
+		assert(slice);
+		sliced_work.push_back(std::move(slice));
+	}
+
+	/**
+	 * \brief executes the next slice of the current work tick.
+	 *
+	 * The first slice fires the work tick,
+	 * then the sliced work is executed in the order it was added.
+	 * \returns slice_result::done if the work tick is complete.
+	 */
+	slice_result work_slice()
+	{
+		if (!in_tick)
+		{
+			in_tick = true;
+			next_sliced_work = 0;
+			work.fire();
+		}
+		for (; next_sliced_work != sliced_work.size(); ++next_sliced_work)
+			if (sliced_work[next_sliced_work]() == slice_result::yield)
+				return slice_result::yield;
+		in_tick = false;
+		return slice_result::done;
+	}
+
+	/**
+	 * \brief executes the work of the region only in cycles, in which it was triggered.
+	 *
+	 * The region is triggered, if a buffered event connection into the region
+	 * has events to deliver on the work tick.
+	 * Regions with other handlers connected to the work tick, like region_worker_nodes
+	 * or buffers of state connections, with sliced or with parallel work are triggered every cycle.
+	 * Switch ticks are sent and virtual time advances in all cycles,
+	 * thus skipped cycles do not change the timing of the other regions.
+	 * Events fired into the region without buffer, for example by nodes without region,
+	 * do not trigger it.
+	 */
+	void set_run_when_triggered(bool triggered) { run_when_triggered = triggered; }
+	bool runs_when_triggered() const { return run_when_triggered; }
+
+	/**
+	 * \brief registers a handler of the work tick, which only needs the tick if pending is true.
+	 *
+	 * The trigger is removed, once owner expired.
+	 * \pre pending is not empty
+	 */
+	void add_work_trigger(std::weak_ptr<const void> owner, std::function<bool(void)> pending)
+	{
+		assert(pending);
+		triggers.push_back(work_trigger{std::move(owner), std::move(pending)});
+	}
+
+	/**
+	 * \brief checks if the work tick has to be executed in the current cycle.
+	 * Call after the switch tick of the cycle.
+	 * \returns true if the region does not run when triggered or it is triggered.
+	 */
+	bool has_pending_work()
+	{
+		if (!run_when_triggered)
+			return true;
+		triggers.erase(std::remove_if(triggers.begin(), triggers.end(),
+				[](const work_trigger& trigger) { return trigger.owner.expired(); }),
+				triggers.end());
+		if (work.nr_connected_handlers() > triggers.size() || !sliced_work.empty()
+				|| !parallel_ticks.empty())
+			return true;
+		return std::any_of(triggers.begin(), triggers.end(),
+				[](const work_trigger& trigger) { return trigger.pending(); });
+	}
 
 	pure::event_source<void> switch_buffers_;
 	pure::event_source<void> work;
+
+private:
+	struct work_trigger
+	{
+		std::weak_ptr<const void> owner;
+		std::function<bool(void)> pending;
+	};
+
+	std::vector<work_trigger> triggers;
+	bool run_when_triggered = false;
+
+	std::vector<std::function<slice_result(void)>> sliced_work;
+	/// work ticks of the groups of parallel work, nodes keep references to the sources.
+	std::map<std::size_t, std::unique_ptr<pure::event_source<void>>> parallel_ticks;
+	/// index of the sliced work to continue with in the current work tick.
+	std::size_t next_sliced_work = 0;
+	bool in_tick = false;
 };
 
 /**
@@ -1,6 +1,9 @@
 #include <flexcore/scheduler/parallelscheduler.hpp>
+#include <flexcore/utils/profiling/profiler.hpp>
 
+#include <algorithm>
 #include <cassert>
+#include <string>
 #include <utility>
 
 namespace fc
@@ -16,27 +19,33 @@ int parallel_scheduler::num_threads()
 }
 
 parallel_scheduler::parallel_scheduler() :
+		parallel_scheduler(num_threads())
+{
+}
+
+parallel_scheduler::parallel_scheduler(int nr_of_threads) :
 		thread_pool(),
 		do_work(false),
 		task_queue()
 {
-	start();
+	assert(nr_of_threads > 0);
+	start(nr_of_threads);
 }
 
-
-void parallel_scheduler::start() noexcept
+void parallel_scheduler::start(int nr_of_threads) noexcept
 {
 	do_work = true;
 
 	//fill thread_pool in body of constructor,
 	//since otherwise threads would need to be copied
-	for (int i = 0, e = num_threads(); i != e; ++i)
+	for (int i = 0; i != nr_of_threads; ++i)
 	{
 		thread_pool.push_back(std::thread(
 				//infinite task loop for every thread,
 				//looks for tasks in task_queue and executes them
-				[this] ()
+				[this, i] ()
 				{
+					profiler::get().name_thread("worker " + std::to_string(i));
 					while (true)
 					{
 						task_t task;
@@ -56,8 +65,9 @@ void parallel_scheduler::start() noexcept
 							assert(do_work);
 							assert(!task_queue.empty());
 
-							task = task_queue.front();
-							task_queue.pop();
+							std::pop_heap(task_queue.begin(), task_queue.end(), &later);
+							task = std::move(task_queue.back().task);
+							task_queue.pop_back();
 						}
 						if (task)
 							task();
@@ -101,9 +111,16 @@ size_t parallel_scheduler::nr_of_waiting_tasks() const
 
 void parallel_scheduler::add_task(task_t new_task)
 {
+	add_task(std::move(new_task), deadline_t::zero());
+}
+
+void parallel_scheduler::add_task(task_t new_task, deadline_t deadline)
+{
+	const auto due = wall_clock::steady::now() + deadline;
 	{
 		queue_lock lock(task_queue_mutex);
-		task_queue.push(std::move(new_task));
+		task_queue.push_back(queued_task{due, next_sequence++, std::move(new_task)});
+		std::push_heap(task_queue.begin(), task_queue.end(), &later);
 	}
 	thread_control.notify_one();
 	assert(!thread_pool.empty()); //check invariant
@@ -3,11 +3,11 @@
 
 #include <flexcore/scheduler/scheduler.hpp>
 
-#include <thread>
-#include <vector>
-#include <queue>
 #include <condition_variable>
+#include <cstddef>
 #include <mutex>
+#include <thread>
+#include <vector>
 
 namespace fc
 {
@@ -17,7 +17,10 @@ namespace thread
 /**
  * \brief simple scheduler based on a threadpool
  *
- * Adds tasks a task queue. These tasks are then assigned to worker threads in a pool
+ * Adds tasks a task queue. These tasks are then assigned to worker threads in a pool.
+ * Tasks are executed earliest deadline first,
+ * thus tasks of fast ticks are not queued behind long tasks of slow ticks.
+ * Tasks with equal deadlines are executed in the order they were added.
  *
  * \invariant thread_pool.size() > 0
  */
@@ -27,25 +30,49 @@ public:
 	static int num_threads();
 
 	parallel_scheduler();
+	/**
+	 * \brief constructs scheduler with a pool of nr_of_threads worker threads
+	 * \pre nr_of_threads > 0
+	 */
+	explicit parallel_scheduler(int nr_of_threads);
 	parallel_scheduler(const parallel_scheduler&) = delete;
 	~parallel_scheduler() override;
 
-	///adds a new task and notifies waiting threads.
+	///adds a new task, which is due immediately, and notifies waiting threads.
 	void add_task(task_t new_task) override;
+	///adds a new task, which is due after deadline, and notifies waiting threads.
+	void add_task(task_t new_task, deadline_t deadline) override;
 	/// stops the work loop of all threads
 	void stop() noexcept override;
 	size_t nr_of_waiting_tasks() const override;
 
 private:
 	/// startes the work loop of all threads
-	void start() noexcept;
+	void start(int nr_of_threads) noexcept;
 
 	std::vector<std::thread> thread_pool;
 	bool do_work; ///< flag indicates threads to keep working.
 
+	struct queued_task
+	{
+		wall_clock::steady::time_point deadline;
+		/// order of adding, keeps tasks with equal deadline in fifo order.
+		std::size_t sequence;
+		task_t task;
+	};
+	/// orders the heap of tasks so that the earliest deadline is on top.
+	static bool later(const queued_task& lhs, const queued_task& rhs)
+	{
+		return lhs.deadline != rhs.deadline
+				? lhs.deadline > rhs.deadline
+				: lhs.sequence > rhs.sequence;
+	}
+
 	// current implementation is simple and based on locking the task_queue,
 	//might be worthwhile exchanging it for a lockfree one.
-	std::queue<task_t> task_queue;
+	/// heap ordered by later
+	std::vector<queued_task> task_queue;
+	std::size_t next_sequence = 0;
 	mutable std::mutex task_queue_mutex;
 	using queue_lock = std::unique_lock<std::mutex>;
 	///used to notify worker threads if new tasks are available
@@ -1,7 +1,10 @@
 #ifndef SRC_THREADING_SCHEDULER_HPP_
 #define SRC_THREADING_SCHEDULER_HPP_
 
+#include <flexcore/scheduler/clock.hpp>
+
 #include <functional>
+#include <utility>
 
 namespace fc
 {
@@ -11,7 +14,22 @@ class scheduler
 {
 public:
 	using task_t = std::function<void(void)>;
+	/// time from adding a task until it should be done.
+	using deadline_t = wall_clock::steady::duration;
+
+	/// adds a task which is due immediately.
 	virtual void add_task(task_t new_task) = 0;
+	/**
+	 * \brief adds a task which should be done within deadline.
+	 *
+	 * Schedulers may use the deadline to run urgent tasks first,
+	 * by default it is ignored and the task is added like any other.
+	 */
+	virtual void add_task(task_t new_task, deadline_t deadline)
+	{
+		static_cast<void>(deadline);
+		add_task(std::move(new_task));
+	}
 	virtual void stop() = 0;
 	virtual size_t nr_of_waiting_tasks() const = 0;
 	virtual ~scheduler() = default;
@@ -1,5 +1,8 @@
 #include <flexcore/scheduler/serialschedulers.hpp>
 
+#include <stdexcept>
+#include <utility>
+
 namespace fc
 {
 namespace thread
@@ -7,10 +10,35 @@ namespace thread
 
 void blocking_scheduler::add_task(task_t new_task)
 {
+	if (executing.load() == std::this_thread::get_id())
+	{
+		// the mutex is already held by this thread in the outer add_task.
+		deferred.push_back(std::move(new_task));
+		return;
+	}
+
 	std::lock_guard<std::mutex> lock(mutex);
 	if (stopped)
 		throw std::runtime_error{"attempting to add a task to stopped scheduler."};
+	executing.store(std::this_thread::get_id());
+	/// ends execution even if a task throws, deferred tasks of the failed task are discarded.
+	struct execution_guard
+	{
+		~execution_guard()
+		{
+			self.deferred.clear();
+			self.executing.store(std::thread::id{});
+		}
+		blocking_scheduler& self;
+	} guard{*this};
+
 	new_task();
+	while (!deferred.empty())
+	{
+		const auto task = std::move(deferred.front());
+		deferred.pop_front();
+		task();
+	}
 }
 
 void blocking_scheduler::stop()
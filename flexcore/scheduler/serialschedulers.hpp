@@ -2,16 +2,25 @@
 #define SRC_THREADING_SERIALSCHEDULER_HPP_
 
 #include <flexcore/scheduler/scheduler.hpp>
+
+#include <atomic>
+#include <deque>
 #include <mutex>
+#include <thread>
 
 namespace fc
 {
 namespace thread
 {
-/// A scheduler that blocks and executes a task as soon as it is added.
+/**
+ * \brief A scheduler that blocks and executes a task as soon as it is added.
+ *
+ * Tasks added by a task are executed after it, before add_task returns.
+ */
 class blocking_scheduler : public scheduler
 {
 public:
+	using scheduler::add_task;
 	void add_task(task_t new_task) override;
 	void stop() override;
 	size_t nr_of_waiting_tasks() const override;
@@ -21,6 +30,9 @@ public:
 private:
 	mutable std::mutex mutex;
 	bool stopped = false;
+	/// thread currently executing tasks, tasks it adds are deferred.
+	std::atomic<std::thread::id> executing{};
+	std::deque<task_t> deferred;
 };
 } /* namespace thread */
 } /* namespace fc */
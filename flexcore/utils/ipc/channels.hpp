@@ -0,0 +1,229 @@
+#ifndef FLEXCORE_UTILS_IPC_CHANNELS_HPP_
+#define FLEXCORE_UTILS_IPC_CHANNELS_HPP_
+
+#include <flexcore/utils/ipc/shared_memory.hpp>
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+
+namespace fc
+{
+namespace ipc
+{
+namespace detail
+{
+constexpr std::size_t cache_line = 64;
+
+/// Header placed at the start of every channel, used to detect mismatched channels.
+struct channel_header
+{
+	std::uint64_t magic;
+	std::uint64_t element_size;
+	std::uint64_t capacity;
+};
+
+template <class channel_t>
+channel_t* checked_channel(const shared_memory_segment& segment, std::uint64_t magic,
+		std::size_t element_size)
+{
+	if (segment.size() < sizeof(channel_t))
+		throw std::runtime_error{"shared memory " + segment.name() + " is too small"};
+	auto* channel = static_cast<channel_t*>(segment.data());
+	if (channel->header.magic != magic || channel->header.element_size != element_size)
+		throw std::runtime_error{"shared memory " + segment.name()
+				+ " does not contain a channel of the expected type"};
+	return channel;
+}
+} // namespace detail
+
+/**
+ * \brief Lock-free single producer single consumer queue in shared memory.
+ *
+ * The producer and the consumer may live in different processes.
+ * Elements are copied with memcpy, thus T needs to be trivially copyable.
+ *
+ * \tparam T type of elements in the queue.
+ */
+template <class T>
+class spsc_ring
+{
+	static_assert(std::is_trivially_copyable<T>{},
+			"only trivially copyable types can be exchanged through shared memory");
+public:
+	/// Creates shared memory object name with a queue of capacity elements.
+	static spsc_ring create(const std::string& name, std::size_t capacity)
+	{
+		assert(capacity > 0);
+		auto segment = shared_memory_segment::create(name,
+				sizeof(layout) + capacity * sizeof(T));
+		auto* channel = new (segment.data()) layout{};
+		channel->header = detail::channel_header{magic, sizeof(T), capacity};
+		return spsc_ring{std::move(segment), channel};
+	}
+
+	/// Opens the queue in shared memory object name created by another spsc_ring.
+	static spsc_ring open(const std::string& name)
+	{
+		auto segment = shared_memory_segment::open(name);
+		auto* channel = detail::checked_channel<layout>(segment, magic, sizeof(T));
+		if (segment.size() < sizeof(layout) + channel->header.capacity * sizeof(T))
+			throw std::runtime_error{"shared memory " + name + " is too small"};
+		return spsc_ring{std::move(segment), channel};
+	}
+
+	/**
+	 * \brief Appends element to the queue. May only be called by the producer.
+	 * \returns false if the queue is full, the element is dropped in that case.
+	 */
+	bool push(const T& element)
+	{
+		const auto write = channel->write.load(std::memory_order_relaxed);
+		const auto read = channel->read.load(std::memory_order_acquire);
+		if (write - read == channel->header.capacity)
+			return false;
+		std::memcpy(slot(write), &element, sizeof(T));
+		channel->write.store(write + 1, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * \brief Calls action with every element currently in the queue and removes them.
+	 * May only be called by the consumer.
+	 * Elements are passed by reference to their slot in the shared memory.
+	 * \returns number of elements consumed.
+	 */
+	template <class action_t>
+	std::size_t consume_all(action_t&& action)
+	{
+		const auto read = channel->read.load(std::memory_order_relaxed);
+		const auto write = channel->write.load(std::memory_order_acquire);
+		for (auto i = read; i != write; ++i)
+			action(*reinterpret_cast<const T*>(slot(i)));
+		channel->read.store(write, std::memory_order_release);
+		return static_cast<std::size_t>(write - read);
+	}
+
+	/// number of elements in the queue.
+	std::size_t size() const
+	{
+		return static_cast<std::size_t>(channel->write.load(std::memory_order_acquire)
+				- channel->read.load(std::memory_order_acquire));
+	}
+	std::size_t capacity() const { return channel->header.capacity; }
+
+private:
+	static constexpr std::uint64_t magic = 0x66632d72696e6701; // "fc-ring" v1
+
+	struct layout
+	{
+		detail::channel_header header;
+		alignas(detail::cache_line) std::atomic<std::uint64_t> write;
+		alignas(detail::cache_line) std::atomic<std::uint64_t> read;
+		alignas(detail::cache_line) char elements[1];
+	};
+
+	spsc_ring(shared_memory_segment s, layout* c) : segment(std::move(s)), channel(c)
+	{
+		assert(channel->write.is_lock_free());
+	}
+
+	char* slot(std::uint64_t index)
+	{
+		return channel->elements + (index % channel->header.capacity) * sizeof(T);
+	}
+
+	shared_memory_segment segment;
+	layout* channel;
+};
+
+/**
+ * \brief Single value in shared memory protected by a sequence lock.
+ *
+ * A single writer stores values, which are read by any number of readers
+ * in any process without locks. Readers retry if they raced with the writer.
+ *
+ * \tparam T type of the value, needs to be trivially copyable.
+ */
+template <class T>
+class seqlock_slot
+{
+	static_assert(std::is_trivially_copyable<T>{},
+			"only trivially copyable types can be exchanged through shared memory");
+public:
+	/// Creates shared memory object name containing a single value.
+	static seqlock_slot create(const std::string& name)
+	{
+		auto segment = shared_memory_segment::create(name, sizeof(layout));
+		auto* channel = new (segment.data()) layout{};
+		channel->header = detail::channel_header{magic, sizeof(T), 1};
+		return seqlock_slot{std::move(segment), channel};
+	}
+
+	/// Opens the value in shared memory object name created by another seqlock_slot.
+	static seqlock_slot open(const std::string& name)
+	{
+		auto segment = shared_memory_segment::open(name);
+		auto* channel = detail::checked_channel<layout>(segment, magic, sizeof(T));
+		return seqlock_slot{std::move(segment), channel};
+	}
+
+	/// Stores value. May only be called by a single writer.
+	void store(const T& value)
+	{
+		const auto sequence = channel->sequence.load(std::memory_order_relaxed);
+		channel->sequence.store(sequence + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		std::memcpy(channel->value, &value, sizeof(T));
+		channel->sequence.store(sequence + 2, std::memory_order_release);
+	}
+
+	/**
+	 * \brief loads the current value into value.
+	 * \returns false if no value was stored yet, value is unchanged in this case.
+	 */
+	bool load(T& value) const
+	{
+		std::uint64_t before = 0;
+		std::uint64_t after = 0;
+		alignas(T) char copy[sizeof(T)];
+		do
+		{
+			before = channel->sequence.load(std::memory_order_acquire);
+			if (before == 0)
+				return false;
+			std::memcpy(copy, channel->value, sizeof(T));
+			std::atomic_thread_fence(std::memory_order_acquire);
+			after = channel->sequence.load(std::memory_order_relaxed);
+		} while (before != after || (before & 1) != 0);
+		std::memcpy(&value, copy, sizeof(T));
+		return true;
+	}
+
+private:
+	static constexpr std::uint64_t magic = 0x66632d736c6f7401; // "fc-slot" v1
+
+	struct layout
+	{
+		detail::channel_header header;
+		alignas(detail::cache_line) std::atomic<std::uint64_t> sequence;
+		alignas(T) char value[sizeof(T)];
+	};
+
+	seqlock_slot(shared_memory_segment s, layout* c) : segment(std::move(s)), channel(c)
+	{
+		assert(channel->sequence.is_lock_free());
+	}
+
+	shared_memory_segment segment;
+	layout* channel;
+};
+
+} // namespace ipc
+} // namespace fc
+
+#endif /* FLEXCORE_UTILS_IPC_CHANNELS_HPP_ */
@@ -0,0 +1,131 @@
+#include <flexcore/utils/ipc/shared_memory.hpp>
+
+#include <cassert>
+#include <cerrno>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fc
+{
+namespace ipc
+{
+
+namespace
+{
+std::string full_object_name(const std::string& name)
+{
+	if (!name.empty() && name.front() == '/')
+		return name;
+	return "/" + name;
+}
+
+[[noreturn]] void throw_errno(int err, const std::string& what)
+{
+	throw std::system_error(err, std::generic_category(), what);
+}
+
+void* map(int fd, std::size_t size, const std::string& name)
+{
+	void* address = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (address == MAP_FAILED)
+	{
+		const auto err = errno;
+		::close(fd);
+		throw_errno(err, "cannot map shared memory " + name);
+	}
+	// the mapping stays valid after the descriptor is closed.
+	::close(fd);
+	return address;
+}
+} // namespace
+
+shared_memory_segment shared_memory_segment::create(const std::string& name, std::size_t size)
+{
+	assert(size > 0);
+	auto full_name = full_object_name(name);
+	const int fd = ::shm_open(full_name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+	if (fd < 0)
+		throw_errno(errno, "cannot create shared memory " + full_name);
+	if (::ftruncate(fd, static_cast<off_t>(size)) != 0)
+	{
+		const auto err = errno;
+		::close(fd);
+		::shm_unlink(full_name.c_str());
+		throw_errno(err, "cannot resize shared memory " + full_name);
+	}
+	void* address = nullptr;
+	try
+	{
+		address = map(fd, size, full_name);
+	}
+	catch (...)
+	{
+		::shm_unlink(full_name.c_str());
+		throw;
+	}
+	return shared_memory_segment{std::move(full_name), address, size, true};
+}
+
+shared_memory_segment shared_memory_segment::open(const std::string& name)
+{
+	auto full_name = full_object_name(name);
+	const int fd = ::shm_open(full_name.c_str(), O_RDWR, 0600);
+	if (fd < 0)
+		throw_errno(errno, "cannot open shared memory " + full_name);
+	struct stat object_stat{};
+	if (::fstat(fd, &object_stat) != 0)
+	{
+		const auto err = errno;
+		::close(fd);
+		throw_errno(err, "cannot stat shared memory " + full_name);
+	}
+	const auto size = static_cast<std::size_t>(object_stat.st_size);
+	void* address = map(fd, size, full_name);
+	return shared_memory_segment{std::move(full_name), address, size, false};
+}
+
+shared_memory_segment::shared_memory_segment(
+		std::string name, void* address, std::size_t size, bool owner)
+	: object_name(std::move(name))
+	, address(address)
+	, length(size)
+	, owner(owner)
+{
+	assert(address);
+}
+
+shared_memory_segment::shared_memory_segment(shared_memory_segment&& other) noexcept
+	: object_name(std::move(other.object_name))
+	, address(other.address)
+	, length(other.length)
+	, owner(other.owner)
+{
+	other.address = nullptr;
+	other.owner = false;
+}
+
+shared_memory_segment& shared_memory_segment::operator=(shared_memory_segment&& other) noexcept
+{
+	std::swap(object_name, other.object_name);
+	std::swap(address, other.address);
+	std::swap(length, other.length);
+	std::swap(owner, other.owner);
+	return *this;
+}
+
+shared_memory_segment::~shared_memory_segment()
+{
+	if (!address)
+		return;
+	::munmap(address, length);
+	if (owner)
+		::shm_unlink(object_name.c_str());
+}
+
+} // namespace ipc
+} // namespace fc
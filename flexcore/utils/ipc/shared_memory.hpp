@@ -0,0 +1,63 @@
+#ifndef FLEXCORE_UTILS_IPC_SHARED_MEMORY_HPP_
+#define FLEXCORE_UTILS_IPC_SHARED_MEMORY_HPP_
+
+#include <cstddef>
+#include <string>
+
+namespace fc
+{
+
+/// Communication between flexcore processes on the same host.
+namespace ipc
+{
+
+/**
+ * \brief RAII wrapper around a mapped POSIX shared memory object.
+ *
+ * The segment which creates the shared memory object owns it
+ * and unlinks it on destruction.
+ * Processes which opened the object keep their mapping until they are done with it.
+ *
+ * \invariant data() != nullptr
+ */
+class shared_memory_segment
+{
+public:
+	/**
+	 * \brief Creates a new shared memory object and maps it.
+	 * \param name name of the object, a leading '/' is added if missing.
+	 * \param size size of the object in bytes, it is zero initialized.
+	 * \throws std::system_error if an object with this name exists already.
+	 */
+	static shared_memory_segment create(const std::string& name, std::size_t size);
+
+	/**
+	 * \brief Opens and maps an existing shared memory object.
+	 * \throws std::system_error if no object with this name exists.
+	 */
+	static shared_memory_segment open(const std::string& name);
+
+	shared_memory_segment(shared_memory_segment&& other) noexcept;
+	shared_memory_segment& operator=(shared_memory_segment&& other) noexcept;
+	shared_memory_segment(const shared_memory_segment&) = delete;
+	shared_memory_segment& operator=(const shared_memory_segment&) = delete;
+
+	~shared_memory_segment();
+
+	void* data() const { return address; }
+	std::size_t size() const { return length; }
+	const std::string& name() const { return object_name; }
+
+private:
+	shared_memory_segment(std::string name, void* address, std::size_t size, bool owner);
+
+	std::string object_name;
+	void* address;
+	std::size_t length;
+	bool owner;
+};
+
+} // namespace ipc
+} // namespace fc
+
+#endif /* FLEXCORE_UTILS_IPC_SHARED_MEMORY_HPP_ */
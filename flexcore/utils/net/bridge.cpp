@@ -0,0 +1,203 @@
+#include <flexcore/utils/net/bridge.hpp>
+
+#include <cassert>
+#include <system_error>
+#include <utility>
+
+namespace fc
+{
+namespace net
+{
+
+namespace
+{
+/// pause between attempts to connect to a receiver which is not yet available.
+constexpr auto reconnect_interval = std::chrono::milliseconds(50);
+}
+
+bridge_sender::bridge_sender(endpoint remote, std::size_t capacity)
+	: remote(std::move(remote))
+	, capacity(capacity)
+	, queue_mutex()
+	, queue_signal()
+	, queue()
+	, sending(false)
+	, stop(false)
+	, frames_sent(0)
+	, error()
+	, connection()
+	, sender_thread()
+{
+	assert(capacity > 0);
+	sender_thread = std::thread([this](){ send_loop(); });
+}
+
+bridge_sender::~bridge_sender()
+{
+	{
+		std::lock_guard<std::mutex> lock(queue_mutex);
+		stop = true;
+		if (connection)
+			connection->shutdown();
+	}
+	queue_signal.notify_all();
+	sender_thread.join();
+}
+
+void bridge_sender::send(std::string frame)
+{
+	std::unique_lock<std::mutex> lock(queue_mutex);
+	queue_signal.wait(lock, [this](){ return queue.size() < capacity || error; });
+	if (error)
+		std::rethrow_exception(error);
+	queue.push_back(std::move(frame));
+	lock.unlock();
+	queue_signal.notify_all();
+}
+
+void bridge_sender::flush()
+{
+	std::unique_lock<std::mutex> lock(queue_mutex);
+	queue_signal.wait(lock, [this](){ return (queue.empty() && !sending) || error; });
+	if (error)
+		std::rethrow_exception(error);
+}
+
+std::size_t bridge_sender::nr_of_frames_sent() const
+{
+	std::lock_guard<std::mutex> lock(queue_mutex);
+	return frames_sent;
+}
+
+void bridge_sender::send_loop()
+{
+	std::unique_lock<std::mutex> lock(queue_mutex);
+	while (!stop)
+	{
+		if (!connection)
+		{
+			lock.unlock();
+			try
+			{
+				auto established = std::make_unique<socket>(socket::connect(remote));
+				lock.lock();
+				connection = std::move(established);
+			}
+			catch (const std::system_error&)
+			{
+				lock.lock();
+				queue_signal.wait_for(lock, reconnect_interval, [this](){ return stop; });
+			}
+			continue;
+		}
+
+		queue_signal.wait(lock, [this](){ return stop || !queue.empty(); });
+		if (stop)
+			return;
+		// the frame stays in the queue while it is sent, so that it counts against capacity.
+		sending = true;
+		const auto& frame = queue.front();
+		lock.unlock();
+		try
+		{
+			connection->send_frame(frame);
+		}
+		catch (...)
+		{
+			lock.lock();
+			sending = false;
+			if (!stop)
+				error = std::current_exception();
+			queue_signal.notify_all();
+			return;
+		}
+		lock.lock();
+		queue.pop_front();
+		sending = false;
+		++frames_sent;
+		queue_signal.notify_all();
+	}
+}
+
+bridge_receiver::bridge_receiver(const endpoint& local, std::size_t capacity)
+	: transport(local.transport)
+	, capacity(capacity)
+	, listener(socket::bind(local))
+	, queue_mutex()
+	, queue_signal()
+	, queue()
+	, stop(false)
+	, error()
+	, connection()
+	, receiver_thread()
+{
+	assert(capacity > 0);
+	receiver_thread = std::thread([this](){ receive_loop(); });
+}
+
+bridge_receiver::~bridge_receiver()
+{
+	{
+		std::lock_guard<std::mutex> lock(queue_mutex);
+		stop = true;
+		listener.shutdown();
+		if (connection)
+			connection->shutdown();
+	}
+	queue_signal.notify_all();
+	receiver_thread.join();
+}
+
+bool bridge_receiver::wait_for_frame(std::chrono::milliseconds timeout)
+{
+	std::unique_lock<std::mutex> lock(queue_mutex);
+	return queue_signal.wait_for(lock, timeout, [this](){ return !queue.empty() || error; });
+}
+
+void bridge_receiver::receive_loop()
+{
+	try
+	{
+		std::string frame;
+		while (true)
+		{
+			const socket* source = &listener;
+			if (transport == protocol::tcp)
+			{
+				auto accepted = std::make_unique<socket>(listener.accept());
+				std::lock_guard<std::mutex> lock(queue_mutex);
+				if (stop)
+					return;
+				connection = std::move(accepted);
+				source = connection.get();
+			}
+
+			while (source->receive_frame(frame))
+			{
+				std::unique_lock<std::mutex> lock(queue_mutex);
+				queue_signal.wait(lock, [this](){ return stop || queue.size() < capacity; });
+				if (stop)
+					return;
+				queue.push_back(std::move(frame));
+				lock.unlock();
+				queue_signal.notify_all();
+			}
+
+			// the sender closed the connection or the receiver is shut down.
+			std::lock_guard<std::mutex> lock(queue_mutex);
+			if (stop)
+				return;
+			connection.reset();
+		}
+	}
+	catch (...)
+	{
+		std::lock_guard<std::mutex> lock(queue_mutex);
+		if (!stop)
+			error = std::current_exception();
+		queue_signal.notify_all();
+	}
+}
+
+} // namespace net
+} // namespace fc
@@ -0,0 +1,139 @@
+#ifndef FLEXCORE_UTILS_NET_BRIDGE_HPP_
+#define FLEXCORE_UTILS_NET_BRIDGE_HPP_
+
+#include <flexcore/utils/net/socket.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace fc
+{
+namespace net
+{
+
+/**
+ * \brief Sends frames to a bridge_receiver from a background thread.
+ *
+ * Frames are queued by send and transmitted in order.
+ * The queue holds at most capacity frames, if it is full send blocks
+ * until the network has caught up. Thus a slow receiver slows down the sender
+ * instead of letting the queue grow without bounds.
+ *
+ * The connection is established in the background,
+ * the sender keeps trying until the receiver is available.
+ */
+class bridge_sender
+{
+public:
+	static constexpr std::size_t default_capacity = 64;
+
+	explicit bridge_sender(endpoint remote, std::size_t capacity = default_capacity);
+	~bridge_sender();
+
+	bridge_sender(const bridge_sender&) = delete;
+	bridge_sender& operator=(const bridge_sender&) = delete;
+
+	/**
+	 * \brief Queues frame for transmission, blocks while the queue is full.
+	 * \throws std::system_error if an earlier frame could not be sent.
+	 */
+	void send(std::string frame);
+
+	/// Blocks until all queued frames have been sent.
+	void flush();
+
+	/// number of frames sent so far.
+	std::size_t nr_of_frames_sent() const;
+
+private:
+	void send_loop();
+
+	const endpoint remote;
+	const std::size_t capacity;
+	mutable std::mutex queue_mutex;
+	std::condition_variable queue_signal;
+	std::deque<std::string> queue;
+	bool sending;
+	bool stop;
+	std::size_t frames_sent;
+	std::exception_ptr error;
+	std::unique_ptr<socket> connection;
+	std::thread sender_thread;
+};
+
+/**
+ * \brief Receives frames sent by a bridge_sender in a background thread.
+ *
+ * The receiver binds to its local endpoint on construction.
+ * For tcp it accepts a single connection at a time.
+ *
+ * Received frames are queued until they are taken by take_all.
+ * The queue holds at most capacity frames, if it is full the receiver
+ * stops reading from the network. With tcp this propagates backpressure
+ * to the sender, with udp further datagrams are dropped by the operating system.
+ */
+class bridge_receiver
+{
+public:
+	static constexpr std::size_t default_capacity = 64;
+
+	/// \throws std::system_error if local cannot be bound.
+	explicit bridge_receiver(const endpoint& local, std::size_t capacity = default_capacity);
+	~bridge_receiver();
+
+	bridge_receiver(const bridge_receiver&) = delete;
+	bridge_receiver& operator=(const bridge_receiver&) = delete;
+
+	/**
+	 * \brief Removes all received frames from the queue and passes them to action.
+	 * \param action callable taking const std::string&, called in order of reception.
+	 * \throws std::system_error if receiving failed.
+	 */
+	template <class action_t>
+	void take_all(action_t&& action)
+	{
+		std::deque<std::string> frames;
+		{
+			std::lock_guard<std::mutex> lock(queue_mutex);
+			if (error)
+				std::rethrow_exception(error);
+			frames.swap(queue);
+		}
+		queue_signal.notify_all();
+		for (const auto& frame : frames)
+			action(frame);
+	}
+
+	/// Blocks until at least one frame is queued or timeout has passed.
+	bool wait_for_frame(std::chrono::milliseconds timeout);
+
+	/// port the receiver is bound to, useful if it was bound to port 0.
+	std::uint16_t local_port() const { return listener.local_port(); }
+
+private:
+	void receive_loop();
+
+	const protocol transport;
+	const std::size_t capacity;
+	socket listener;
+	std::mutex queue_mutex;
+	std::condition_variable queue_signal;
+	std::deque<std::string> queue;
+	bool stop;
+	std::exception_ptr error;
+	std::unique_ptr<socket> connection;
+	std::thread receiver_thread;
+};
+
+} // namespace net
+} // namespace fc
+
+#endif /* FLEXCORE_UTILS_NET_BRIDGE_HPP_ */
@@ -0,0 +1,279 @@
+#include <flexcore/utils/net/socket.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace fc
+{
+namespace net
+{
+
+namespace
+{
+[[noreturn]] void throw_errno(int err, const std::string& what)
+{
+	throw std::system_error(err, std::generic_category(), what);
+}
+
+std::string describe(const endpoint& ep)
+{
+	return ep.host + ":" + std::to_string(ep.port);
+}
+
+sockaddr_in resolve(const endpoint& ep)
+{
+	addrinfo hints{};
+	hints.ai_family = AF_INET;
+	hints.ai_socktype = ep.transport == protocol::tcp ? SOCK_STREAM : SOCK_DGRAM;
+	addrinfo* result = nullptr;
+	const int err = ::getaddrinfo(ep.host.c_str(), nullptr, &hints, &result);
+	if (err != 0 || !result)
+		throw std::runtime_error{"cannot resolve " + describe(ep) + ": " + ::gai_strerror(err)};
+	sockaddr_in address{};
+	std::memcpy(&address, result->ai_addr, sizeof(address));
+	::freeaddrinfo(result);
+	address.sin_port = htons(ep.port);
+	return address;
+}
+
+int open_socket(const endpoint& ep)
+{
+	const int fd = ::socket(AF_INET,
+			ep.transport == protocol::tcp ? SOCK_STREAM : SOCK_DGRAM, 0);
+	if (fd < 0)
+		throw_errno(errno, "cannot create socket for " + describe(ep));
+	return fd;
+}
+
+void put_u32(std::string& out, std::uint32_t value)
+{
+	const std::uint32_t net_value = htonl(value);
+	out.append(reinterpret_cast<const char*>(&net_value), sizeof(net_value));
+}
+
+std::uint32_t get_u32(const char* in)
+{
+	std::uint32_t net_value = 0;
+	std::memcpy(&net_value, in, sizeof(net_value));
+	return ntohl(net_value);
+}
+
+/// \returns false if the peer closed the connection before size bytes were received.
+bool receive_all(int fd, char* buffer, std::size_t size)
+{
+	while (size > 0)
+	{
+		const auto received = ::recv(fd, buffer, size, 0);
+		if (received == 0)
+			return false;
+		if (received < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			if (errno == EINVAL || errno == ENOTCONN) // socket was shut down
+				return false;
+			throw_errno(errno, "cannot receive frame");
+		}
+		buffer += received;
+		size -= static_cast<std::size_t>(received);
+	}
+	return true;
+}
+
+void send_all(int fd, const char* buffer, std::size_t size)
+{
+	while (size > 0)
+	{
+		const auto sent = ::send(fd, buffer, size, MSG_NOSIGNAL);
+		if (sent < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			throw_errno(errno, "cannot send frame");
+		}
+		buffer += sent;
+		size -= static_cast<std::size_t>(sent);
+	}
+}
+} // namespace
+
+socket socket::bind(const endpoint& ep)
+{
+	auto address = resolve(ep);
+	socket result{open_socket(ep), ep.transport};
+	const int reuse = 1;
+	::setsockopt(result.descriptor, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+	if (::bind(result.descriptor, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+		throw_errno(errno, "cannot bind to " + describe(ep));
+	if (ep.transport == protocol::tcp && ::listen(result.descriptor, 1) != 0)
+		throw_errno(errno, "cannot listen on " + describe(ep));
+	return result;
+}
+
+socket socket::connect(const endpoint& ep)
+{
+	auto address = resolve(ep);
+	socket result{open_socket(ep), ep.transport};
+	if (::connect(result.descriptor, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+		throw_errno(errno, "cannot connect to " + describe(ep));
+	if (ep.transport == protocol::tcp)
+	{
+		// frames are sent as a whole, waiting for more data only adds latency.
+		const int no_delay = 1;
+		::setsockopt(result.descriptor, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+	}
+	return result;
+}
+
+socket::socket(int descriptor, protocol transport)
+	: descriptor(descriptor)
+	, transport(transport)
+{
+	assert(descriptor >= 0);
+}
+
+socket::socket(socket&& other) noexcept
+	: descriptor(other.descriptor)
+	, transport(other.transport)
+{
+	other.descriptor = -1;
+}
+
+socket& socket::operator=(socket&& other) noexcept
+{
+	std::swap(descriptor, other.descriptor);
+	std::swap(transport, other.transport);
+	return *this;
+}
+
+socket::~socket()
+{
+	if (descriptor >= 0)
+		::close(descriptor);
+}
+
+socket socket::accept() const
+{
+	assert(transport == protocol::tcp);
+	int fd = -1;
+	do
+	{
+		fd = ::accept(descriptor, nullptr, nullptr);
+	} while (fd < 0 && errno == EINTR);
+	if (fd < 0)
+		throw_errno(errno, "cannot accept connection");
+	return socket{fd, transport};
+}
+
+void socket::send_frame(const std::string& frame) const
+{
+	if (transport == protocol::udp)
+	{
+		if (frame.size() > max_datagram)
+			throw std::runtime_error{"frame of " + std::to_string(frame.size())
+					+ " bytes exceeds the maximum udp datagram size"};
+		send_all(descriptor, frame.data(), frame.size());
+		return;
+	}
+	std::string length;
+	put_u32(length, static_cast<std::uint32_t>(frame.size()));
+	send_all(descriptor, length.data(), length.size());
+	send_all(descriptor, frame.data(), frame.size());
+}
+
+bool socket::receive_frame(std::string& frame) const
+{
+	if (transport == protocol::udp)
+	{
+		frame.resize(max_datagram);
+		ssize_t received = 0;
+		do
+		{
+			received = ::recv(descriptor, &frame[0], frame.size(), 0);
+		} while (received < 0 && errno == EINTR);
+		if (received < 0)
+			throw_errno(errno, "cannot receive frame");
+		// a shut down udp socket returns empty datagrams.
+		frame.resize(static_cast<std::size_t>(received));
+		return received > 0;
+	}
+	char length[sizeof(std::uint32_t)];
+	if (!receive_all(descriptor, length, sizeof(length)))
+		return false;
+	frame.resize(get_u32(length));
+	return frame.empty() || receive_all(descriptor, &frame[0], frame.size());
+}
+
+void socket::shutdown() const
+{
+	::shutdown(descriptor, SHUT_RDWR);
+}
+
+std::uint16_t socket::local_port() const
+{
+	sockaddr_in address{};
+	socklen_t length = sizeof(address);
+	if (::getsockname(descriptor, reinterpret_cast<sockaddr*>(&address), &length) != 0)
+		throw_errno(errno, "cannot query local port");
+	return ntohs(address.sin_port);
+}
+
+std::string encode_batch(const std::vector<std::string>& tokens)
+{
+	std::size_t size = sizeof(std::uint32_t);
+	for (const auto& token : tokens)
+		size += sizeof(std::uint32_t) + token.size();
+	std::string batch;
+	batch.reserve(size);
+	put_u32(batch, static_cast<std::uint32_t>(tokens.size()));
+	for (const auto& token : tokens)
+	{
+		put_u32(batch, static_cast<std::uint32_t>(token.size()));
+		batch += token;
+	}
+	return batch;
+}
+
+std::vector<std::string> decode_batch(const std::string& batch)
+{
+	const auto malformed = []() { return std::runtime_error{"malformed token batch"}; };
+	std::size_t offset = 0;
+	const auto read_u32 = [&]()
+	{
+		if (batch.size() - offset < sizeof(std::uint32_t))
+			throw malformed();
+		const auto value = get_u32(batch.data() + offset);
+		offset += sizeof(std::uint32_t);
+		return value;
+	};
+
+	const auto count = read_u32();
+	std::vector<std::string> tokens;
+	tokens.reserve(std::min<std::size_t>(count, batch.size() / sizeof(std::uint32_t)));
+	for (std::uint32_t i = 0; i < count; ++i)
+	{
+		const auto size = read_u32();
+		if (batch.size() - offset < size)
+			throw malformed();
+		tokens.emplace_back(batch, offset, size);
+		offset += size;
+	}
+	if (offset != batch.size())
+		throw malformed();
+	return tokens;
+}
+
+} // namespace net
+} // namespace fc
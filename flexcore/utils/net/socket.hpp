@@ -0,0 +1,113 @@
+#ifndef FLEXCORE_UTILS_NET_SOCKET_HPP_
+#define FLEXCORE_UTILS_NET_SOCKET_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace fc
+{
+
+/// Exchange of tokens between flexcore instances over the network.
+namespace net
+{
+
+enum class protocol
+{
+	tcp,
+	udp
+};
+
+/// Address of a bridge, host is a numeric IPv4 address or a host name.
+struct endpoint
+{
+	protocol transport;
+	std::string host;
+	std::uint16_t port;
+};
+
+/**
+ * \brief RAII wrapper around a socket descriptor which sends and receives frames.
+ *
+ * A frame is an arbitrary sequence of bytes which is delivered as a whole.
+ * With tcp every frame is prefixed with its length in network byte order,
+ * with udp every frame is a single datagram and is limited to max_datagram bytes.
+ */
+class socket
+{
+public:
+	static constexpr std::size_t max_datagram = 65507;
+
+	/**
+	 * \brief Binds a socket to the local address of ep.
+	 *
+	 * For tcp the socket listens for a connection, which is obtained by accept.
+	 * For udp frames can be received directly.
+	 * Port 0 binds to any free port, see local_port.
+	 * \throws std::system_error if the address cannot be bound.
+	 */
+	static socket bind(const endpoint& ep);
+
+	/**
+	 * \brief Connects a socket to the remote address of ep.
+	 * \throws std::system_error if no connection can be established.
+	 */
+	static socket connect(const endpoint& ep);
+
+	socket(socket&& other) noexcept;
+	socket& operator=(socket&& other) noexcept;
+	socket(const socket&) = delete;
+	socket& operator=(const socket&) = delete;
+	~socket();
+
+	/**
+	 * \brief Waits for a connection on a listening tcp socket.
+	 * \throws std::system_error on failure or if the socket was shut down.
+	 */
+	socket accept() const;
+
+	/**
+	 * \brief Sends frame completely, blocks if the receiver does not keep up.
+	 * \throws std::system_error if the frame cannot be sent.
+	 */
+	void send_frame(const std::string& frame) const;
+
+	/**
+	 * \brief Blocks until a complete frame was received.
+	 * \returns false if the connection was closed or the socket was shut down.
+	 * \throws std::system_error on errors.
+	 */
+	bool receive_frame(std::string& frame) const;
+
+	/// Unblocks all pending and future calls of accept, receive_frame and send_frame.
+	void shutdown() const;
+
+	/// port the socket is bound to locally.
+	std::uint16_t local_port() const;
+
+private:
+	socket(int descriptor, protocol transport);
+
+	int descriptor;
+	protocol transport;
+};
+
+/**
+ * \brief Frames several serialized tokens into a single message.
+ *
+ * The batch consists of the number of tokens followed by each token
+ * prefixed with its size, all sizes are 32 bit in network byte order.
+ */
+std::string encode_batch(const std::vector<std::string>& tokens);
+
+/**
+ * \brief Splits a message created by encode_batch into its tokens.
+ * \throws std::runtime_error if batch is malformed.
+ */
+std::vector<std::string> decode_batch(const std::string& batch);
+
+} // namespace net
+} // namespace fc
+
+#endif /* FLEXCORE_UTILS_NET_SOCKET_HPP_ */
@@ -0,0 +1,290 @@
+#include <flexcore/utils/profiling/profiler.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <iomanip>
+
+namespace fc
+{
+
+namespace
+{
+const char* category_name(trace_category category)
+{
+	switch (category)
+	{
+	case trace_category::cycle: return "cycle";
+	case trace_category::switch_tick: return "switch_tick";
+	case trace_category::work_tick: return "work_tick";
+	case trace_category::task: return "task";
+	case trace_category::node: return "node";
+	}
+	return "unknown";
+}
+
+/// writes str as json string including quotes.
+void write_json_string(std::ostream& out, const std::string& str)
+{
+	out << '"';
+	for (const char c : str)
+	{
+		switch (c)
+		{
+		case '"': out << "\\\""; break;
+		case '\\': out << "\\\\"; break;
+		case '\n': out << "\\n"; break;
+		case '\t': out << "\\t"; break;
+		default:
+			if (static_cast<unsigned char>(c) < 0x20)
+				out << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+					<< static_cast<int>(c) << std::dec << std::setfill(' ');
+			else
+				out << c;
+		}
+	}
+	out << '"';
+}
+
+/// trace event timestamps are microseconds.
+void write_microseconds(std::ostream& out, std::uint64_t ns)
+{
+	out << ns / 1000 << '.' << std::setw(3) << std::setfill('0') << ns % 1000
+		<< std::setfill(' ');
+}
+}
+
+profiler& profiler::get()
+{
+	static profiler instance;
+	return instance;
+}
+
+profiler::profiler() : epoch(clock::now().time_since_epoch().count())
+{
+}
+
+void profiler::start(std::size_t spans_per_thread, bool record_node_handlers)
+{
+	assert(spans_per_thread > 0);
+	{
+		std::lock_guard<std::mutex> lock(registry_mutex);
+		epoch.store(clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+		capacity.store(spans_per_thread, std::memory_order_relaxed);
+		node_handlers.store(record_node_handlers, std::memory_order_relaxed);
+		// spans of exited threads are discarded with the previous recording.
+		for (auto& buffer : buffers)
+		{
+			if (!buffer.in_use)
+			{
+				buffer.spans.reset();
+				buffer.capacity = 0;
+			}
+		}
+		generation.fetch_add(1, std::memory_order_release);
+	}
+	recording_.store(true, std::memory_order_release);
+	assert(recording());
+}
+
+void profiler::stop()
+{
+	recording_.store(false, std::memory_order_release);
+	assert(!recording());
+}
+
+profiler::name_id profiler::intern(const std::string& name)
+{
+	std::lock_guard<std::mutex> lock(registry_mutex);
+	const auto it = name_ids.find(name);
+	if (it != name_ids.end())
+		return it->second;
+	const auto id = static_cast<name_id>(names.size());
+	names.push_back(name);
+	name_ids.emplace(name, id);
+	return id;
+}
+
+void profiler::name_thread(const std::string& name)
+{
+	auto& buffer = local_buffer();
+	std::lock_guard<std::mutex> lock(registry_mutex);
+	buffer.thread_name = name;
+}
+
+profiler::thread_buffer& profiler::local_buffer()
+{
+	/// returns the buffer of its thread to the profiler, when the thread exits.
+	struct buffer_lease
+	{
+		~buffer_lease()
+		{
+			if (buffer)
+				profiler::get().release_buffer(*buffer);
+		}
+		thread_buffer* buffer = nullptr;
+	};
+	thread_local buffer_lease lease;
+	if (!lease.buffer)
+	{
+		std::lock_guard<std::mutex> lock(registry_mutex);
+		lease.buffer = &acquire_buffer();
+	}
+	assert(lease.buffer);
+	return *lease.buffer;
+}
+
+profiler::thread_buffer& profiler::acquire_buffer()
+{
+	// buffers with spans of the current recording are kept until it is written.
+	const auto current = generation.load(std::memory_order_relaxed);
+	const auto reusable = std::find_if(buffers.begin(), buffers.end(),
+			[current](const thread_buffer& buffer)
+			{
+				return !buffer.in_use
+						&& (buffer.generation.load(std::memory_order_relaxed) != current
+								|| (buffer.size.load(std::memory_order_relaxed) == 0
+										&& buffer.dropped.load(std::memory_order_relaxed) == 0));
+			});
+	if (reusable != buffers.end())
+	{
+		// resets the buffer on the first span of its new thread.
+		reusable->generation.store(0, std::memory_order_relaxed);
+		reusable->in_use = true;
+		reusable->thread_name = "thread " + std::to_string(reusable->track);
+		return *reusable;
+	}
+
+	buffers.emplace_back();
+	auto& buffer = buffers.back();
+	buffer.track = static_cast<std::uint32_t>(buffers.size());
+	buffer.thread_name = "thread " + std::to_string(buffer.track);
+	return buffer;
+}
+
+void profiler::release_buffer(thread_buffer& buffer)
+{
+	std::lock_guard<std::mutex> lock(registry_mutex);
+	assert(buffer.in_use);
+	buffer.in_use = false;
+	// spans of older recordings are not needed anymore, the memory is released right away.
+	if (buffer.generation.load(std::memory_order_relaxed)
+			!= generation.load(std::memory_order_relaxed))
+	{
+		buffer.spans.reset();
+		buffer.capacity = 0;
+	}
+}
+
+void profiler::record(trace_category category, name_id name, clock::time_point begin,
+		clock::time_point end)
+{
+	assert(begin <= end);
+	if (!recording_.load(std::memory_order_acquire))
+		return;
+
+	auto& buffer = local_buffer();
+	// acquire, as start publishes epoch with generation.
+	const auto current = generation.load(std::memory_order_acquire);
+	if (buffer.generation.load(std::memory_order_relaxed) != current)
+	{
+		// first span of this thread in a new recording, only this thread writes its buffer.
+		const auto new_capacity = capacity.load(std::memory_order_relaxed);
+		if (buffer.capacity != new_capacity)
+		{
+			buffer.spans.reset(new span[new_capacity]);
+			buffer.capacity = new_capacity;
+		}
+		buffer.size.store(0, std::memory_order_relaxed);
+		buffer.dropped.store(0, std::memory_order_relaxed);
+		buffer.generation.store(current, std::memory_order_release);
+	}
+
+	const auto size = buffer.size.load(std::memory_order_relaxed);
+	if (size == buffer.capacity)
+	{
+		buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+	const clock::time_point start{clock::duration{epoch.load(std::memory_order_relaxed)}};
+	const auto since_epoch = begin < start ? clock::duration::zero() : begin - start;
+	buffer.spans[size] = span{
+			static_cast<std::uint64_t>(
+					std::chrono::duration_cast<std::chrono::nanoseconds>(since_epoch).count()),
+			static_cast<std::uint64_t>(
+					std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count()),
+			name, category};
+	// publishes the span to write_trace
+	buffer.size.store(size + 1, std::memory_order_release);
+}
+
+std::size_t profiler::nr_of_spans() const
+{
+	std::lock_guard<std::mutex> lock(registry_mutex);
+	const auto current = generation.load(std::memory_order_relaxed);
+	std::size_t result = 0;
+	for (const auto& buffer : buffers)
+		if (buffer.generation.load(std::memory_order_acquire) == current)
+			result += buffer.size.load(std::memory_order_acquire);
+	return result;
+}
+
+std::size_t profiler::nr_of_dropped_spans() const
+{
+	std::lock_guard<std::mutex> lock(registry_mutex);
+	const auto current = generation.load(std::memory_order_relaxed);
+	std::size_t result = 0;
+	for (const auto& buffer : buffers)
+		if (buffer.generation.load(std::memory_order_acquire) == current)
+			result += buffer.dropped.load(std::memory_order_relaxed);
+	return result;
+}
+
+std::size_t profiler::nr_of_thread_buffers() const
+{
+	std::lock_guard<std::mutex> lock(registry_mutex);
+	return buffers.size();
+}
+
+void profiler::write_trace(std::ostream& out) const
+{
+	std::lock_guard<std::mutex> lock(registry_mutex);
+	const auto current = generation.load(std::memory_order_relaxed);
+
+	out << "{\"traceEvents\":[";
+	bool first = true;
+	const auto separator = [&out, &first]()
+	{
+		if (!first)
+			out << ",\n";
+		first = false;
+	};
+	for (const auto& buffer : buffers)
+	{
+		if (buffer.generation.load(std::memory_order_acquire) != current)
+			continue;
+		separator();
+		out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer.track
+			<< ",\"args\":{\"name\":";
+		write_json_string(out, buffer.thread_name);
+		out << "}}";
+
+		const auto size = buffer.size.load(std::memory_order_acquire);
+		for (std::size_t i = 0; i != size; ++i)
+		{
+			const auto& s = buffer.spans[i];
+			assert(s.name < names.size());
+			separator();
+			out << "{\"name\":";
+			write_json_string(out, names[s.name]);
+			out << ",\"cat\":\"" << category_name(s.category)
+				<< "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer.track << ",\"ts\":";
+			write_microseconds(out, s.begin_ns);
+			out << ",\"dur\":";
+			write_microseconds(out, s.duration_ns);
+			out << "}";
+		}
+	}
+	out << "],\"displayTimeUnit\":\"ns\"}\n";
+}
+
+} // namespace fc
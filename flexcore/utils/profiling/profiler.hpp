@@ -0,0 +1,186 @@
+#ifndef SRC_UTILS_PROFILING_PROFILER_HPP_
+#define SRC_UTILS_PROFILING_PROFILER_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace fc
+{
+
+/// Kinds of spans recorded by the profiler, exported as trace categories.
+enum class trace_category : std::uint8_t
+{
+	/// cycle_control::work on the main loop thread
+	cycle,
+	/// switch tick of a region
+	switch_tick,
+	/// work tick of a region
+	work_tick,
+	/// periodic task without region
+	task,
+	/// handler of an event_sink or state_source
+	node
+};
+
+/**
+ * \brief Records entry and exit of ticks, tasks and node handlers in a trace.
+ *
+ * Every thread records into its own buffer of fixed capacity without locking,
+ * spans exceeding the capacity are dropped and counted.
+ * The trace is written in the Chrome trace event format,
+ * which can be viewed offline with chrome://tracing or ui.perfetto.dev.
+ * Every thread is a separate track, named by name_thread.
+ *
+ * cycle_control records cycles, switch ticks and work ticks of regions and periodic tasks.
+ * Node handlers are only recorded if requested on start
+ * and flexcore is built with FLEXCORE_ENABLE_PORT_STATISTICS.
+ */
+class profiler
+{
+public:
+	using clock = std::chrono::steady_clock;
+	/// identifies interned names of spans
+	using name_id = std::uint32_t;
+
+	/// get the singleton instance of profiler.
+	static profiler& get();
+
+	/**
+	 * \brief starts recording, discards spans of the previous recording.
+	 * \param spans_per_thread capacity of the buffer of every thread.
+	 * \param node_handlers record spans of node handlers as well
+	 * \pre spans_per_thread > 0
+	 * \pre no thread records spans of a previous recording.
+	 * \post recording()
+	 */
+	void start(std::size_t spans_per_thread = 1 << 16, bool node_handlers = false);
+	/// stops recording, spans already recorded are kept. \post !recording()
+	void stop();
+
+	bool recording() const { return recording_.load(std::memory_order_relaxed); }
+	bool records_node_handlers() const
+	{
+		return recording() && node_handlers.load(std::memory_order_relaxed);
+	}
+
+	/// returns id for name, equal names get equal ids.
+	name_id intern(const std::string& name);
+
+	/// sets the name of the track of the calling thread.
+	void name_thread(const std::string& name);
+
+	/**
+	 * \brief records span of the calling thread, if recording.
+	 * \pre begin <= end
+	 */
+	void record(trace_category category, name_id name, clock::time_point begin,
+			clock::time_point end);
+
+	/// returns the number of spans recorded by all threads.
+	std::size_t nr_of_spans() const;
+	/// returns the number of spans dropped, because a buffer was full.
+	std::size_t nr_of_dropped_spans() const;
+	/// returns the number of thread buffers, buffers of exited threads are reused.
+	std::size_t nr_of_thread_buffers() const;
+
+	/**
+	 * \brief writes all recorded spans as Chrome trace event json to out.
+	 * Spans recorded while writing may be missing.
+	 */
+	void write_trace(std::ostream& out) const;
+
+private:
+	profiler();
+
+	struct span
+	{
+		std::uint64_t begin_ns;
+		std::uint64_t duration_ns;
+		name_id name;
+		trace_category category;
+	};
+
+	/// buffer of a single thread, only written by that thread.
+	struct thread_buffer
+	{
+		std::uint32_t track;
+		std::string thread_name;
+		/// false after the thread exited, guarded by registry_mutex.
+		bool in_use = true;
+		/// recording the spans belong to
+		std::atomic<std::uint64_t> generation{0};
+		std::unique_ptr<span[]> spans;
+		std::size_t capacity = 0;
+		std::atomic<std::size_t> size{0};
+		std::atomic<std::size_t> dropped{0};
+	};
+
+	thread_buffer& local_buffer();
+	/// returns a free buffer or a new one, called with registry_mutex locked.
+	thread_buffer& acquire_buffer();
+	/// called on exit of the thread owning buffer.
+	void release_buffer(thread_buffer& buffer);
+
+	std::atomic<bool> recording_{false};
+	std::atomic<bool> node_handlers{false};
+	/// incremented on every start, thread buffers of older generations are reset.
+	std::atomic<std::uint64_t> generation{0};
+	std::atomic<std::size_t> capacity{0};
+	/// start of the recording as time since epoch of clock, published with generation.
+	std::atomic<clock::rep> epoch;
+
+	mutable std::mutex registry_mutex;
+	std::deque<thread_buffer> buffers;
+	std::vector<std::string> names;
+	std::map<std::string, name_id> name_ids;
+};
+
+/**
+ * \brief Records a span from construction to destruction, if the profiler is recording.
+ *
+ * \code{cpp}
+ * {
+ *     profile_scope scope{trace_category::task, id};
+ *     work();
+ * }
+ * \endcode
+ */
+class profile_scope
+{
+public:
+	profile_scope(trace_category category, profiler::name_id name)
+		: category(category)
+		, name(name)
+		, active(profiler::get().recording())
+		, begin(active ? profiler::clock::now() : profiler::clock::time_point{})
+	{
+	}
+
+	profile_scope(const profile_scope&) = delete;
+	profile_scope& operator=(const profile_scope&) = delete;
+
+	~profile_scope()
+	{
+		if (active)
+			profiler::get().record(category, name, begin, profiler::clock::now());
+	}
+
+private:
+	trace_category category;
+	profiler::name_id name;
+	bool active;
+	profiler::clock::time_point begin;
+};
+
+} // namespace fc
+
+#endif /* SRC_UTILS_PROFILING_PROFILER_HPP_ */
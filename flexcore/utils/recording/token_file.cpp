@@ -0,0 +1,333 @@
+#include <flexcore/utils/recording/token_file.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fc
+{
+namespace recording
+{
+
+namespace
+{
+std::size_t page_size()
+{
+	static const auto size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+	return size;
+}
+
+std::size_t round_to_pages(std::size_t bytes)
+{
+	const auto page = page_size();
+	return (bytes + page - 1) / page * page;
+}
+
+void throw_errno(const char* what)
+{
+	throw std::system_error(errno, std::generic_category(), what);
+}
+} // namespace
+
+token_file_writer::token_file_writer(const std::string& file_name, std::size_t chunk_size_)
+	: file(::open(file_name.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644))
+	, chunk_size(round_to_pages(std::max(chunk_size_, sizeof(format::chunk_header))))
+	, file_end(round_to_pages(sizeof(format::file_header)))
+	, chunk(nullptr)
+	, records_written(0)
+	, pending()
+	, writing()
+	, stop(false)
+	, busy(false)
+	, error()
+	, queue_mutex()
+	, queue_signal()
+	, writer_thread()
+{
+	if (file < 0)
+		throw_errno("cannot open token file");
+
+	format::file_header header{};
+	std::memcpy(header.magic, format::magic, sizeof(header.magic));
+	header.version = format::version;
+	header.first_chunk = file_end;
+	if (::ftruncate(file, static_cast<off_t>(file_end)) != 0
+			|| ::pwrite(file, &header, sizeof(header), 0) != sizeof(header))
+	{
+		const auto err = errno;
+		::close(file);
+		throw std::system_error(err, std::generic_category(), "cannot write token file header");
+	}
+
+	writer_thread = std::thread([this](){ write_loop(); });
+}
+
+token_file_writer::~token_file_writer()
+{
+	{
+		std::lock_guard<std::mutex> lock(queue_mutex);
+		stop = true;
+	}
+	queue_signal.notify_all();
+	writer_thread.join();
+	close_chunk();
+	::close(file);
+}
+
+void token_file_writer::append(virtual_clock::steady::time_point timestamp, std::string payload)
+{
+	{
+		std::lock_guard<std::mutex> lock(queue_mutex);
+		rethrow_error();
+		pending.push_back(record{timestamp.time_since_epoch().count(), std::move(payload)});
+	}
+	queue_signal.notify_one();
+}
+
+void token_file_writer::flush()
+{
+	std::unique_lock<std::mutex> lock(queue_mutex);
+	queue_signal.wait(lock, [this](){ return (pending.empty() && !busy) || error; });
+	rethrow_error();
+}
+
+std::size_t token_file_writer::nr_of_records() const
+{
+	std::lock_guard<std::mutex> lock(queue_mutex);
+	return records_written;
+}
+
+void token_file_writer::rethrow_error()
+{
+	if (error)
+		std::rethrow_exception(error);
+}
+
+void token_file_writer::write_loop()
+{
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(queue_mutex);
+			busy = false;
+			queue_signal.notify_all(); // wake up threads waiting in flush
+			queue_signal.wait(lock, [this](){ return stop || !pending.empty(); });
+			if (pending.empty() || error)
+				return;
+			// swap keeps the capacity of both queues, which avoids allocations after warmup.
+			swap(pending, writing);
+			busy = true;
+		}
+
+		try
+		{
+			for (const auto& r : writing)
+				write(r);
+		}
+		catch (...)
+		{
+			std::lock_guard<std::mutex> lock(queue_mutex);
+			error = std::current_exception();
+		}
+
+		const auto written = writing.size();
+		writing.clear();
+		std::lock_guard<std::mutex> lock(queue_mutex);
+		records_written += written;
+	}
+}
+
+void token_file_writer::write(const record& r)
+{
+	const auto needed = format::record_size(r.payload.size());
+	auto* header = reinterpret_cast<format::chunk_header*>(chunk);
+	if (!chunk || header->size - header->used < needed)
+	{
+		new_chunk(needed + sizeof(format::chunk_header));
+		header = reinterpret_cast<format::chunk_header*>(chunk);
+	}
+	assert(header->size - header->used >= needed);
+
+	const format::record_header record_head{r.timestamp, r.payload.size()};
+	char* position = chunk + header->used;
+	std::memcpy(position, &record_head, sizeof(record_head));
+	std::memcpy(position + sizeof(record_head), r.payload.data(), r.payload.size());
+
+	if (header->records == 0)
+		header->first_timestamp = r.timestamp;
+	header->last_timestamp = r.timestamp;
+	++header->records;
+	// used is updated last, so readers only ever see completely written records.
+	header->used += needed;
+}
+
+void token_file_writer::new_chunk(std::size_t min_size)
+{
+	close_chunk();
+
+	const auto size = std::max(chunk_size, round_to_pages(min_size));
+	if (::ftruncate(file, static_cast<off_t>(file_end + size)) != 0)
+		throw_errno("cannot grow token file");
+
+	void* mapped = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+			file, static_cast<off_t>(file_end));
+	if (mapped == MAP_FAILED)
+		throw_errno("cannot map token file chunk");
+
+	chunk = static_cast<char*>(mapped);
+	file_end += size;
+
+	auto* header = reinterpret_cast<format::chunk_header*>(chunk);
+	header->size = size;
+	header->used = sizeof(format::chunk_header);
+	header->records = 0;
+	header->first_timestamp = 0;
+	header->last_timestamp = 0;
+}
+
+void token_file_writer::close_chunk()
+{
+	if (!chunk)
+		return;
+	const auto size = reinterpret_cast<format::chunk_header*>(chunk)->size;
+	::munmap(chunk, size);
+	chunk = nullptr;
+}
+
+token_file_reader::token_file_reader(const std::string& file_name)
+	: mapping(nullptr)
+	, mapping_size(0)
+	, chunks()
+{
+	const int file = ::open(file_name.c_str(), O_RDONLY);
+	if (file < 0)
+		throw_errno("cannot open token file");
+
+	struct stat file_stat{};
+	if (::fstat(file, &file_stat) != 0)
+	{
+		const auto err = errno;
+		::close(file);
+		throw std::system_error(err, std::generic_category(), "cannot stat token file");
+	}
+	mapping_size = static_cast<std::size_t>(file_stat.st_size);
+
+	format::file_header header{};
+	if (mapping_size >= sizeof(header))
+	{
+		void* mapped = ::mmap(nullptr, mapping_size, PROT_READ, MAP_SHARED, file, 0);
+		const auto err = errno;
+		::close(file); // the mapping stays valid after the file is closed
+		if (mapped == MAP_FAILED)
+			throw std::system_error(err, std::generic_category(), "cannot map token file");
+		mapping = static_cast<char*>(mapped);
+		std::memcpy(&header, mapping, sizeof(header));
+	}
+	else
+		::close(file);
+
+	if (!mapping || std::memcmp(header.magic, format::magic, sizeof(header.magic)) != 0
+			|| header.version != format::version)
+	{
+		if (mapping)
+			::munmap(mapping, mapping_size);
+		throw std::runtime_error{"not a token file: " + file_name};
+	}
+
+	// walk the chunk headers only, the records are not touched.
+	for (auto offset = header.first_chunk;
+			offset + sizeof(format::chunk_header) <= mapping_size;)
+	{
+		format::chunk_header chunk{};
+		std::memcpy(&chunk, mapping + offset, sizeof(chunk));
+		if (chunk.size == 0 || offset + chunk.size > mapping_size)
+			break; // chunk was not completely written
+		if (chunk.records > 0)
+			chunks.push_back(chunk_entry{mapping + offset, chunk.used, chunk.records,
+					chunk.first_timestamp, chunk.last_timestamp});
+		offset += chunk.size;
+	}
+	// advise kernel for a sequential access pattern
+	::madvise(mapping, mapping_size, MADV_SEQUENTIAL);
+}
+
+token_file_reader::~token_file_reader()
+{
+	::munmap(mapping, mapping_size);
+}
+
+token_file_reader::cursor token_file_reader::begin() const
+{
+	return cursor{0, sizeof(format::chunk_header)};
+}
+
+token_file_reader::cursor token_file_reader::seek(virtual_clock::steady::time_point t) const
+{
+	const auto time = t.time_since_epoch().count();
+	// first chunk which contains records not earlier than t
+	const auto chunk = std::lower_bound(chunks.begin(), chunks.end(), time,
+			[](const chunk_entry& entry, std::int64_t value)
+			{
+				return entry.last_timestamp < value;
+			});
+
+	cursor c{static_cast<std::size_t>(chunk - chunks.begin()), sizeof(format::chunk_header)};
+	while (!at_end(c) && read(c).timestamp < t)
+		advance(c);
+	return c;
+}
+
+bool token_file_reader::at_end(const cursor& c) const
+{
+	return c.chunk >= chunks.size();
+}
+
+token_file_reader::record_view token_file_reader::read(const cursor& c) const
+{
+	assert(!at_end(c));
+	assert(c.offset < chunks[c.chunk].used);
+	format::record_header header{};
+	const char* position = chunks[c.chunk].begin + c.offset;
+	std::memcpy(&header, position, sizeof(header));
+	return record_view{
+			virtual_clock::steady::time_point{virtual_clock::duration{header.timestamp}},
+			position + sizeof(header),
+			static_cast<std::size_t>(header.size)};
+}
+
+void token_file_reader::advance(cursor& c) const
+{
+	assert(!at_end(c));
+	format::record_header header{};
+	std::memcpy(&header, chunks[c.chunk].begin + c.offset, sizeof(header));
+	c.offset += format::record_size(header.size);
+	skip_exhausted(c);
+}
+
+void token_file_reader::skip_exhausted(cursor& c) const
+{
+	while (!at_end(c) && c.offset >= chunks[c.chunk].used)
+	{
+		++c.chunk;
+		c.offset = sizeof(format::chunk_header);
+	}
+}
+
+std::size_t token_file_reader::nr_of_records() const
+{
+	std::size_t result = 0;
+	for (const auto& chunk : chunks)
+		result += chunk.records;
+	return result;
+}
+
+} // namespace recording
+} // namespace fc
@@ -0,0 +1,238 @@
+#ifndef FLEXCORE_UTILS_RECORDING_TOKEN_FILE_HPP_
+#define FLEXCORE_UTILS_RECORDING_TOKEN_FILE_HPP_
+
+#include <flexcore/scheduler/clock.hpp>
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fc
+{
+
+/// Recording of tokens flowing through ports into files and their replay.
+namespace recording
+{
+
+/**
+ * \brief On-disk layout of recorded token files.
+ *
+ * A token file starts with a file_header, followed by a sequence of chunks.
+ * Every chunk starts at a page aligned offset with a chunk_header,
+ * followed by records.
+ * Each record consists of a record_header and the serialized token.
+ * Records never cross chunk boundaries and are aligned to record_alignment.
+ * A chunk is grown beyond the default chunk size if a single record requires it.
+ *
+ * All values are stored in host byte order.
+ */
+namespace format
+{
+constexpr char magic[8] = {'F', 'C', 'T', 'O', 'K', 'E', 'N', 'S'};
+constexpr std::uint32_t version = 1;
+constexpr std::size_t record_alignment = 8;
+
+struct file_header
+{
+	char magic[8];
+	std::uint32_t version;
+	std::uint32_t reserved;
+	/// offset of the first chunk in the file, is a multiple of the page size
+	std::uint64_t first_chunk;
+};
+
+struct chunk_header
+{
+	/// total size of the chunk in bytes including this header
+	std::uint64_t size;
+	/// bytes of the chunk which are in use including this header
+	std::uint64_t used;
+	/// number of records in this chunk
+	std::uint64_t records;
+	/// timestamp of the first record in nanoseconds of virtual_clock::steady
+	std::int64_t first_timestamp;
+	/// timestamp of the last record in nanoseconds of virtual_clock::steady
+	std::int64_t last_timestamp;
+};
+static_assert(sizeof(chunk_header) % record_alignment == 0,
+		"records following the chunk header need to be aligned");
+
+struct record_header
+{
+	/// time the token was recorded in nanoseconds of virtual_clock::steady
+	std::int64_t timestamp;
+	/// size of the serialized token following this header
+	std::uint64_t size;
+};
+
+/// size occupied by a record with a payload of the given size, including padding.
+constexpr std::size_t record_size(std::size_t payload_size)
+{
+	return (sizeof(record_header) + payload_size + record_alignment - 1)
+			/ record_alignment * record_alignment;
+}
+} // namespace format
+
+/**
+ * \brief Appends timestamped tokens to a memory mapped, chunked file.
+ *
+ * append only moves the token into a queue,
+ * the actual write to the mapped file happens in a background thread.
+ * This keeps the cost of recording in the producing region low.
+ *
+ * \invariant writer_thread is running until the token_file_writer is destroyed.
+ */
+class token_file_writer
+{
+public:
+	static constexpr std::size_t default_chunk_size = 1 << 20;
+
+	/**
+	 * \brief Creates or truncates file_name and starts the background writer.
+	 * \param file_name path of the file to write to.
+	 * \param chunk_size size by which the file is grown, rounded up to page size.
+	 * \throws std::system_error if the file cannot be created.
+	 */
+	explicit token_file_writer(const std::string& file_name,
+			std::size_t chunk_size = default_chunk_size);
+
+	token_file_writer(const token_file_writer&) = delete;
+	token_file_writer& operator=(const token_file_writer&) = delete;
+
+	/// Writes all pending tokens, then closes the file.
+	~token_file_writer();
+
+	/**
+	 * \brief queues serialized token for writing.
+	 * \param timestamp time the token was observed.
+	 * \param payload serialized token, may be empty for void events.
+	 * \throws std::system_error if the background writer failed previously.
+	 */
+	void append(virtual_clock::steady::time_point timestamp, std::string payload);
+
+	/**
+	 * \brief blocks until all tokens appended so far are written to the file.
+	 * \throws std::system_error if the background writer failed.
+	 */
+	void flush();
+
+	/// Number of records written to the file so far.
+	std::size_t nr_of_records() const;
+
+private:
+	struct record
+	{
+		std::int64_t timestamp;
+		std::string payload;
+	};
+
+	void write_loop();
+	void write(const record& r);
+	void new_chunk(std::size_t min_size);
+	void close_chunk();
+	void rethrow_error();
+
+	int file;
+	std::size_t chunk_size;
+	std::uint64_t file_end;
+	char* chunk;
+	std::size_t records_written;
+
+	std::vector<record> pending;
+	std::vector<record> writing;
+	bool stop;
+	bool busy;
+	std::exception_ptr error;
+	mutable std::mutex queue_mutex;
+	std::condition_variable queue_signal;
+	std::thread writer_thread;
+};
+
+/**
+ * \brief Provides read access to a token file written by token_file_writer.
+ *
+ * The file is memory mapped read only, thus tokens are only loaded from disk
+ * when they are accessed.
+ * On construction an index of the chunks and their timestamps is built,
+ * which only touches the chunk headers.
+ * This index allows to seek to a timestamp in logarithmic time of the number of chunks.
+ *
+ * Positions in the file are represented by a cursor,
+ * which stays valid as long as the reader exists.
+ */
+class token_file_reader
+{
+public:
+	/// Position of a record in the file.
+	struct cursor
+	{
+		std::size_t chunk;
+		std::uint64_t offset;
+	};
+
+	/// Non owning view on a record in the mapped file.
+	struct record_view
+	{
+		virtual_clock::steady::time_point timestamp;
+		const char* data;
+		std::size_t size;
+
+		std::string payload() const { return std::string(data, size); }
+	};
+
+	/**
+	 * \brief maps file_name and builds the timestamp index.
+	 * \throws std::system_error if the file cannot be opened or mapped.
+	 * \throws std::runtime_error if the file is not a token file.
+	 */
+	explicit token_file_reader(const std::string& file_name);
+
+	token_file_reader(const token_file_reader&) = delete;
+	token_file_reader& operator=(const token_file_reader&) = delete;
+
+	~token_file_reader();
+
+	/// Cursor to the first record in the file.
+	cursor begin() const;
+	/**
+	 * \brief Cursor to the first record with a timestamp not earlier than t.
+	 * \returns cursor for which at_end is true if all records are earlier than t.
+	 */
+	cursor seek(virtual_clock::steady::time_point t) const;
+	/// returns true if c points past the last record.
+	bool at_end(const cursor& c) const;
+	/// \pre !at_end(c)
+	record_view read(const cursor& c) const;
+	/// moves c to the next record. \pre !at_end(c)
+	void advance(cursor& c) const;
+
+	/// Total number of records in the file.
+	std::size_t nr_of_records() const;
+
+private:
+	struct chunk_entry
+	{
+		const char* begin;
+		std::uint64_t used;
+		std::uint64_t records;
+		std::int64_t first_timestamp;
+		std::int64_t last_timestamp;
+	};
+
+	/// moves c to the next non empty chunk if it points to the end of its chunk.
+	void skip_exhausted(cursor& c) const;
+
+	char* mapping;
+	std::size_t mapping_size;
+	std::vector<chunk_entry> chunks;
+};
+
+} // namespace recording
+} // namespace fc
+
+#endif /* FLEXCORE_UTILS_RECORDING_TOKEN_FILE_HPP_ */
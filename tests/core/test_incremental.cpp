@@ -0,0 +1,99 @@
+#include <boost/test/unit_test.hpp>
+#include <flexcore/core/connection.hpp>
+#include <flexcore/core/incremental.hpp>
+#include <flexcore/pure/state_sink.hpp>
+#include <flexcore/pure/state_sources.hpp>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace fc;
+
+BOOST_AUTO_TEST_SUITE(test_incremental)
+
+BOOST_AUTO_TEST_CASE(test_versioned_value)
+{
+	versioned_value<int> value{1};
+	const auto first = value();
+	BOOST_CHECK_EQUAL(first.get(), 1);
+
+	value.set(2);
+	const auto second = value();
+	BOOST_CHECK_EQUAL(second.get(), 2);
+	BOOST_CHECK_NE(first.version(), second.version());
+	// tokens keep the value they were pulled with.
+	BOOST_CHECK_EQUAL(first.get(), 1);
+	BOOST_CHECK(!versioned<int>{}.has_value());
+}
+
+BOOST_AUTO_TEST_CASE(test_only_changed_stages_recompute)
+{
+	versioned_value<std::vector<int>> calibration{{1, 2, 3}};
+	int sums = 0;
+	int scales = 0;
+	pure::state_source<versioned<std::vector<int>>> source{std::ref(calibration)};
+	pure::state_sink<versioned<int>> sink;
+
+	source
+			>> incremental([&sums](const std::vector<int>& v)
+					{
+						++sums;
+						int sum = 0;
+						for (auto i : v)
+							sum += i;
+						return sum;
+					})
+			>> incremental([&scales](int sum) { ++scales; return sum * 2; })
+			>> sink;
+
+	BOOST_CHECK_EQUAL(sink.get().get(), 12);
+	const auto version = sink.get().version();
+	BOOST_CHECK_EQUAL(sink.get().get(), 12);
+	BOOST_CHECK_EQUAL(sums, 1);
+	BOOST_CHECK_EQUAL(scales, 1);
+	BOOST_CHECK_EQUAL(sink.get().version(), version);
+
+	calibration.set({4, 5, 6});
+	BOOST_CHECK_EQUAL(sink.get().get(), 30);
+	BOOST_CHECK_EQUAL(sums, 2);
+	BOOST_CHECK_EQUAL(scales, 2);
+	BOOST_CHECK_NE(sink.get().version(), version);
+}
+
+BOOST_AUTO_TEST_CASE(test_inputs_of_equal_version)
+{
+	// both values are at version 0, the stage needs to tell them apart by their payload.
+	versioned_value<int> first{1};
+	versioned_value<int> second{2};
+	bool use_first = true;
+	int calls = 0;
+	pure::state_source<versioned<int>> source{[&]()
+			{
+				return use_first ? first() : second();
+			}};
+	pure::state_sink<versioned<int>> sink;
+	source >> incremental([&calls](int i) { ++calls; return i * 10; }) >> sink;
+
+	for (int i = 0; i != 4; ++i)
+	{
+		BOOST_CHECK_EQUAL(sink.get().get(), use_first ? 10 : 20);
+		use_first = !use_first;
+	}
+	BOOST_CHECK_EQUAL(calls, 4);
+
+	// repeated pulls of the same input still hit the cache.
+	BOOST_CHECK_EQUAL(sink.get().get(), 10);
+	BOOST_CHECK_EQUAL(sink.get().get(), 10);
+	BOOST_CHECK_EQUAL(calls, 5);
+}
+
+BOOST_AUTO_TEST_CASE(test_type_change)
+{
+	versioned_value<int> value{3};
+	auto chain = std::ref(value)
+			>> incremental([](int i) { return std::string(i, 'a'); });
+	BOOST_CHECK_EQUAL(chain().get(), "aaa");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
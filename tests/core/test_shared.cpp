@@ -0,0 +1,105 @@
+#include <boost/test/unit_test.hpp>
+#include <flexcore/core/connection.hpp>
+#include <flexcore/core/shared.hpp>
+#include <flexcore/extended/ports/node_aware.hpp>
+#include <flexcore/pure/event_sinks.hpp>
+#include <flexcore/pure/event_sources.hpp>
+#include <flexcore/pure/state_sink.hpp>
+#include <flexcore/pure/state_sources.hpp>
+#include <flexcore/scheduler/cyclecontrol.hpp>
+
+#include <vector>
+
+using namespace fc;
+
+namespace
+{
+/// payload which counts how often it was copied.
+struct frame
+{
+	explicit frame(int* copies) : copies(copies) {}
+	frame(const frame& other) : copies(other.copies) { ++*copies; }
+	frame(frame&&) = default;
+	int* copies;
+};
+}
+
+BOOST_AUTO_TEST_SUITE(test_shared)
+
+BOOST_AUTO_TEST_CASE(test_fan_out)
+{
+	int copies = 0;
+	pure::event_source<shared<frame>> source;
+	std::vector<const frame*> received;
+	std::vector<pure::event_sink<shared<frame>>> sinks;
+	sinks.reserve(4);
+	for (int i = 0; i != 4; ++i)
+	{
+		sinks.emplace_back([&received](const shared<frame>& f) { received.push_back(&f.get()); });
+		source >> sinks.back();
+	}
+	// handlers can take the payload directly.
+	source >> [&received](const frame& f) { received.push_back(&f); };
+
+	source.fire(share(frame{&copies}));
+	BOOST_CHECK_EQUAL(copies, 0);
+	BOOST_REQUIRE_EQUAL(received.size(), 5);
+	for (auto payload : received)
+		BOOST_CHECK_EQUAL(payload, received.front());
+
+	// payloads of other types are converted once for all handlers.
+	received.clear();
+	source.fire(frame{&copies});
+	BOOST_CHECK_EQUAL(copies, 0);
+	BOOST_REQUIRE_EQUAL(received.size(), 5);
+	BOOST_CHECK_EQUAL(received.back(), received.front());
+}
+
+BOOST_AUTO_TEST_CASE(test_across_regions)
+{
+	int copies = 0;
+	parallel_region region_1{"r1", thread::cycle_control::fast_tick};
+	parallel_region region_2{"r2", thread::cycle_control::fast_tick};
+	node_aware<pure::event_source<shared<frame>>> source{region_1};
+	const frame* first = nullptr;
+	const frame* second = nullptr;
+	node_aware<pure::event_sink<shared<frame>>> sink_1{region_2,
+			[&first](const shared<frame>& f) { first = &f.get(); }};
+	node_aware<pure::event_sink<shared<frame>>> sink_2{region_2,
+			[&second](const shared<frame>& f) { second = &f.get(); }};
+	source >> sink_1;
+	source >> sink_2;
+
+	auto token = share(frame{&copies});
+	source.fire(token);
+	BOOST_CHECK_GT(token.use_count(), 1);
+	region_1.ticks.switch_buffers();
+	region_2.ticks.in_work()();
+
+	BOOST_CHECK_EQUAL(copies, 0);
+	BOOST_CHECK_EQUAL(first, &token.get());
+	BOOST_CHECK_EQUAL(second, &token.get());
+	BOOST_CHECK_EQUAL(token.use_count(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_state_across_regions)
+{
+	int copies = 0;
+	parallel_region region_1{"r1", thread::cycle_control::fast_tick};
+	parallel_region region_2{"r2", thread::cycle_control::fast_tick};
+	const auto state = share(frame{&copies});
+	node_aware<pure::state_source<shared<frame>>> source{region_1, [&state]() { return state; }};
+	node_aware<pure::state_sink<shared<frame>>> sink{region_2};
+	source >> sink;
+
+	region_1.ticks.in_work()();
+	region_1.ticks.switch_buffers();
+	region_2.ticks.switch_buffers();
+	region_2.ticks.in_work()();
+
+	const auto snapshot = sink.get();
+	BOOST_CHECK_EQUAL(copies, 0);
+	BOOST_CHECK_EQUAL(&snapshot.get(), &state.get());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,69 @@
+#include <boost/test/unit_test.hpp>
+#include <flexcore/core/connection.hpp>
+#include <flexcore/core/token_pool.hpp>
+#include <flexcore/extended/ports/node_aware.hpp>
+#include <flexcore/pure/event_sinks.hpp>
+#include <flexcore/pure/event_sources.hpp>
+#include <flexcore/scheduler/cyclecontrol.hpp>
+
+#include <vector>
+
+using namespace fc;
+
+BOOST_AUTO_TEST_SUITE(test_token_pool)
+
+BOOST_AUTO_TEST_CASE(test_recycling)
+{
+	int created = 0;
+	token_pool<std::vector<int>> pool{[&created]() { ++created; return std::vector<int>(4); }};
+	BOOST_CHECK_EQUAL(pool.size(), 0);
+
+	const int* first_data = nullptr;
+	{
+		auto token = pool.make([](std::vector<int>& v) { v[0] = 1; });
+		first_data = token->data();
+		BOOST_CHECK_EQUAL(token.get()[0], 1);
+		BOOST_CHECK_EQUAL(pool.nr_of_free_payloads(), 0);
+
+		// payloads in use are not handed out again.
+		auto second = pool.make([](std::vector<int>& v) { v[0] = 2; });
+		BOOST_CHECK_NE(second->data(), first_data);
+		BOOST_CHECK_EQUAL(token.get()[0], 1);
+		BOOST_CHECK_EQUAL(created, 2);
+	}
+	BOOST_CHECK_EQUAL(pool.nr_of_free_payloads(), 2);
+
+	for (int i = 0; i != 10; ++i)
+		pool.make([i](std::vector<int>& v) { v[0] = i; });
+	BOOST_CHECK_EQUAL(created, 2);
+
+	pool.reserve(5);
+	BOOST_CHECK_EQUAL(pool.size(), 5);
+	BOOST_CHECK_EQUAL(created, 5);
+}
+
+BOOST_AUTO_TEST_CASE(test_pipeline_across_regions)
+{
+	parallel_region region_1{"r1", thread::cycle_control::fast_tick};
+	parallel_region region_2{"r2", thread::cycle_control::fast_tick};
+	node_aware<pure::event_source<shared<std::vector<int>>>> source{region_1};
+	int sum = 0;
+	node_aware<pure::event_sink<shared<std::vector<int>>>> sink{region_2,
+			[&sum](const std::vector<int>& v) { sum += v[0]; }};
+	source >> sink;
+
+	token_pool<std::vector<int>> pool{[]() { return std::vector<int>(1024); }};
+	for (int tick = 0; tick != 10; ++tick)
+	{
+		for (int i = 0; i != 3; ++i)
+			source.fire(pool.make([](std::vector<int>& v) { v[0] = 1; }));
+		region_1.ticks.switch_buffers();
+		region_2.ticks.in_work()();
+	}
+	BOOST_CHECK_EQUAL(sum, 30);
+	// payloads were recycled after every tick.
+	BOOST_CHECK_EQUAL(pool.size(), 3);
+	BOOST_CHECK_EQUAL(pool.nr_of_free_payloads(), 3);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -86,4 +86,33 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(test_graph_creation, node_t, nodes)
 	BOOST_CHECK_EQUAL(line_count, 10 + 8 + 2);
 }
 
+BOOST_AUTO_TEST_CASE(test_independent_subgraphs)
+{
+	auto& r = forest.nodes();
+	auto other_region = std::make_shared<fc::parallel_region>("other",
+			fc::thread::cycle_control::fast_tick);
+	auto& a_1 = r.make_child_named<fc::event_terminal<int>>("a 1");
+	auto& a_2 = r.make_child_named<fc::event_terminal<int>>("a 2");
+	auto& b_1 = r.make_child_named<fc::event_terminal<int>>("b 1");
+	auto& b_2 = r.make_child_named<fc::event_terminal<int>>("b 2");
+	auto& remote = r.make_child_named<fc::event_terminal<int>>(other_region, "remote");
+
+	a_1.out() >> a_2.in();
+	b_1.out() >> fc::graph::named([](int i){ return i; }, "lambda") >> b_2.in();
+	// connections to other regions are buffered and do not join subgraphs.
+	a_2.out() >> remote.in();
+	remote.out() >> b_1.in();
+
+	const auto id = [](auto& node) { return node.graph_info().get_id(); };
+	const auto subgraphs = fc::graph::independent_subgraphs(graph, *forest.nodes().region());
+	BOOST_REQUIRE_EQUAL(subgraphs.size(), 2);
+	const auto& a = subgraphs[0].count(id(a_1)) ? subgraphs[0] : subgraphs[1];
+	const auto& b = subgraphs[0].count(id(a_1)) ? subgraphs[1] : subgraphs[0];
+	BOOST_CHECK((a == std::set<fc::graph::unique_id>{id(a_1), id(a_2)}));
+	BOOST_CHECK((b == std::set<fc::graph::unique_id>{id(b_1), id(b_2)}));
+
+	a_2.out() >> b_2.in();
+	BOOST_CHECK_EQUAL(fc::graph::independent_subgraphs(graph, *forest.nodes().region()).size(), 1);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,68 @@
+#include <boost/test/unit_test.hpp>
+
+#include <flexcore/batch_runner.hpp>
+#include <flexcore/extended/nodes/region_worker_node.hpp>
+
+#include <stdexcept>
+
+BOOST_AUTO_TEST_SUITE(test_batch_runner)
+
+namespace
+{
+/// counts work ticks of its region
+struct tick_counter : fc::region_worker_node
+{
+	static constexpr auto default_name = "tick_counter";
+	explicit tick_counter(const fc::node_args& node)
+		: region_worker_node([this]() { ++ticks; }, node)
+	{
+	}
+
+	int ticks = 0;
+};
+}
+
+BOOST_AUTO_TEST_CASE(test_independent_runs)
+{
+	using fc::thread::cycle_control;
+	const auto process_time = fc::virtual_clock::steady::now();
+	fc::batch_runner runner{4};
+
+	const auto results = runner.run(8, [](fc::infrastructure& infra, std::size_t i)
+			{
+				auto region = infra.add_region("counted", cycle_control::fast_tick);
+				auto& counter = infra.node_owner().make_child<tick_counter>(region);
+				infra.run_cycles(10 * (i + 1));
+				return counter.ticks;
+			});
+
+	BOOST_CHECK_EQUAL(results.size(), 8);
+	for (std::size_t i = 0; i != results.size(); ++i)
+	{
+		BOOST_CHECK(results[i].succeeded());
+		BOOST_CHECK_EQUAL(results[i].index, i);
+		BOOST_CHECK_EQUAL(results[i].value, 10 * (i + 1));
+		BOOST_CHECK(results[i].virtual_time
+				== static_cast<int>(10 * (i + 1)) * cycle_control::min_tick_length);
+	}
+	// runs have their own clocks
+	BOOST_CHECK(fc::virtual_clock::steady::now() == process_time);
+}
+
+BOOST_AUTO_TEST_CASE(test_failing_run)
+{
+	fc::batch_runner runner{2};
+	const auto results = runner.run(3, [](fc::infrastructure&, std::size_t i)
+			{
+				if (i == 1)
+					throw std::runtime_error{"failed run"};
+				return i;
+			});
+
+	BOOST_CHECK(results[0].succeeded());
+	BOOST_CHECK(!results[1].succeeded());
+	BOOST_CHECK_THROW(std::rethrow_exception(results[1].error), std::runtime_error);
+	BOOST_CHECK_EQUAL(results[2].value, 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
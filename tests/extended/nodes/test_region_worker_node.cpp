@@ -1,4 +1,5 @@
 #include <boost/test/unit_test.hpp>
+#include <flexcore/scheduler/cyclecontrol.hpp>
 #include <flexcore/scheduler/parallelregion.hpp>
 #include <flexcore/extended/nodes/region_worker_node.hpp>
 #include <flexcore/ports.hpp>
@@ -24,6 +25,38 @@ public:
 	event_source<int> out_event_source;
 	int work_counter;
 };
+
+/// counts to three in slices on every work tick.
+struct sliced_counter : public fc::sliced_region_worker_node
+{
+public:
+	explicit sliced_counter(const fc::node_args& node)
+		: sliced_region_worker_node([this]()
+				{
+					out_event_source.fire(++work_counter);
+					return work_counter % 3 == 0 ? fc::slice_result::done : fc::slice_result::yield;
+				}, node)
+		, out_event_source(this)
+		, work_counter(0)
+	{
+	}
+
+	event_source<int> out_event_source;
+	int work_counter;
+};
+
+/// counts work ticks of its group.
+struct parallel_counter : public fc::parallel_region_worker_node
+{
+public:
+	parallel_counter(std::size_t group, const fc::node_args& node)
+		: parallel_region_worker_node([this](){ ++work_counter; }, group, node)
+		, work_counter(0)
+	{
+	}
+
+	int work_counter;
+};
 }
 
 BOOST_AUTO_TEST_CASE(test_worker)
@@ -45,4 +78,60 @@ BOOST_AUTO_TEST_CASE(test_worker)
 		region->ticks.work.fire();
 	}
 }
+
+BOOST_AUTO_TEST_CASE(test_sliced_worker)
+{
+	using fc::operator>>;
+	auto region = std::make_shared<fc::parallel_region>("MyRegion",
+			fc::thread::cycle_control::slow_tick
+			);
+	fc::tests::owning_node owner(region);
+
+	sliced_counter& counter = owner.make_child_named<sliced_counter>("Counter");
+	fc::pure::sink_fixture<int> sink{{1, 2, 3, 4, 5, 6}};
+	counter.out_event_source >> sink;
+
+	BOOST_CHECK(region->ticks.work_slice() == fc::slice_result::yield);
+	BOOST_CHECK(region->ticks.work_slice() == fc::slice_result::yield);
+	BOOST_CHECK(region->ticks.work_slice() == fc::slice_result::done);
+	BOOST_CHECK_EQUAL(counter.work_counter, 3);
+
+	// in_work executes the complete work tick.
+	region->ticks.in_work()();
+	BOOST_CHECK_EQUAL(counter.work_counter, 6);
+}
+
+BOOST_AUTO_TEST_CASE(test_parallel_worker)
+{
+	auto region = std::make_shared<fc::parallel_region>("MyRegion",
+			fc::thread::cycle_control::fast_tick
+			);
+	fc::tests::owning_node owner(region);
+
+	auto& first = owner.make_child_named<parallel_counter>("First", 0);
+	auto& second = owner.make_child_named<parallel_counter>("Second", 3);
+	auto& same_group = owner.make_child_named<parallel_counter>("SameGroup", 3);
+	BOOST_CHECK_EQUAL(region->ticks.nr_of_parallel_groups(), 2);
+
+	// parallel work is not part of the sequential work tick.
+	BOOST_CHECK(region->ticks.work_slice() == fc::slice_result::done);
+	BOOST_CHECK_EQUAL(first.work_counter, 0);
+
+	region->ticks.parallel_work(1);
+	BOOST_CHECK_EQUAL(first.work_counter, 0);
+	BOOST_CHECK_EQUAL(second.work_counter, 1);
+	BOOST_CHECK_EQUAL(same_group.work_counter, 1);
+
+	// in_work executes all groups after the work tick.
+	region->ticks.in_work()();
+	BOOST_CHECK_EQUAL(first.work_counter, 1);
+	BOOST_CHECK_EQUAL(second.work_counter, 2);
+
+	fc::thread::periodic_task task{region};
+	task.set_work_to_do(true);
+	task();
+	BOOST_CHECK(task.done());
+	BOOST_CHECK_EQUAL(first.work_counter, 2);
+	BOOST_CHECK_EQUAL(same_group.work_counter, 3);
+}
 BOOST_AUTO_TEST_SUITE_END()
@@ -9,6 +9,8 @@
 #include <boost/mpl/list.hpp>
 #include <boost/variant.hpp>
 
+#include <vector>
+
 namespace
 {
 template<class base>
@@ -373,4 +375,119 @@ BOOST_AUTO_TEST_CASE(test_state_same_region)
 	BOOST_CHECK_EQUAL(sink.get(), 1);
 }
 
+BOOST_AUTO_TEST_CASE(test_same_region_is_direct)
+{
+	parallel_region region{"r1", fc::thread::cycle_control::fast_tick};
+	node_aware<pure::event_source<int>> source{region};
+	int received = 0;
+	node_aware<pure::event_sink<int>> sink{region, [&received](int i){ received = i; }};
+
+	// bounded policies do not apply to connections within a region.
+	event_buffer_policy policy;
+	policy.capacity = 1;
+	policy.on_overflow = overflow_policy::drop_newest;
+	source.set_buffer_policy(policy);
+	source >> sink;
+	BOOST_CHECK(source.buffer_occupancy().empty());
+
+	source.fire(1);
+	source.fire(2);
+	BOOST_CHECK_EQUAL(received, 2);
+}
+
+BOOST_AUTO_TEST_CASE(test_buffer_policy_per_connection)
+{
+	parallel_region region_1{"r1", fc::thread::cycle_control::fast_tick};
+	parallel_region region_2{"r2", fc::thread::cycle_control::fast_tick};
+
+	node_aware<pure::event_source<int>> source{region_1};
+	std::vector<int> bounded_received;
+	std::vector<int> unbounded_received;
+	node_aware<pure::event_sink<int>> bounded{region_2,
+			[&bounded_received](int i){ bounded_received.push_back(i); }};
+	node_aware<pure::event_sink<int>> unbounded{region_2,
+			[&unbounded_received](int i){ unbounded_received.push_back(i); }};
+	node_aware<pure::event_sink<int>> same_region{region_1, [](int){}};
+
+	event_buffer_policy policy;
+	policy.capacity = 2;
+	policy.on_overflow = overflow_policy::drop_newest;
+	source.set_buffer_policy(policy);
+	source >> bounded;
+	source.set_buffer_policy(event_buffer_policy{});
+	source >> unbounded;
+	source >> same_region;
+
+	// connections in the same region have no buffer
+	BOOST_CHECK_EQUAL(source.buffer_occupancy().size(), 2);
+
+	for (int i = 0; i != 4; ++i)
+		source.fire(i);
+	const auto occupancy = source.buffer_occupancy();
+	BOOST_CHECK_EQUAL(occupancy[0].depth, 2);
+	BOOST_CHECK_EQUAL(occupancy[0].dropped, 2);
+	BOOST_CHECK_EQUAL(occupancy[1].depth, 4);
+	BOOST_CHECK_EQUAL(occupancy[1].dropped, 0);
+
+	region_1.ticks.switch_buffers();
+	region_2.ticks.in_work()();
+	BOOST_CHECK((bounded_received == std::vector<int>{0, 1}));
+	BOOST_CHECK((unbounded_received == std::vector<int>{0, 1, 2, 3}));
+	BOOST_CHECK_EQUAL(source.buffer_occupancy()[1].high_watermark, 4);
+}
+
+BOOST_AUTO_TEST_CASE(test_coalescing_connection)
+{
+	parallel_region region_1{"r1", fc::thread::cycle_control::fast_tick};
+	parallel_region region_2{"r2", fc::thread::cycle_control::fast_tick};
+
+	node_aware<pure::event_source<int>> source{region_1};
+	std::vector<int> received;
+	node_aware<pure::event_sink<int>> sink{region_2,
+			[&received](int i){ received.push_back(i); }};
+
+	source.set_coalescing(keep_latest<int>());
+	source >> sink;
+
+	for (int i = 0; i != 4; ++i)
+		source.fire(i);
+	BOOST_CHECK_EQUAL(source.buffer_occupancy()[0].depth, 1);
+
+	region_1.ticks.switch_buffers();
+	region_2.ticks.in_work()();
+	BOOST_CHECK((received == std::vector<int>{3}));
+	BOOST_CHECK_EQUAL(source.buffer_occupancy()[0].coalesced, 3);
+}
+
+BOOST_AUTO_TEST_CASE(test_buffer_triggers_region)
+{
+	parallel_region region_1{"r1", fc::thread::cycle_control::fast_tick};
+	parallel_region region_2{"r2", fc::thread::cycle_control::fast_tick};
+	region_2.ticks.set_run_when_triggered(true);
+
+	node_aware<pure::event_source<int>> source{region_1};
+	std::vector<int> received;
+	node_aware<pure::event_sink<int>> sink{region_2,
+			[&received](int i){ received.push_back(i); }};
+	source >> sink;
+	BOOST_CHECK(!region_2.ticks.has_pending_work());
+
+	// events only trigger the region once they are switched to it.
+	source.fire(1);
+	BOOST_CHECK(!region_2.ticks.has_pending_work());
+	region_1.ticks.switch_buffers();
+	BOOST_CHECK(region_2.ticks.has_pending_work());
+	region_2.ticks.in_work()();
+	BOOST_CHECK((received == std::vector<int>{1}));
+	BOOST_CHECK(!region_2.ticks.has_pending_work());
+
+	// state connections pull on every work tick of the source region.
+	region_1.ticks.set_run_when_triggered(true);
+	BOOST_CHECK(!region_1.ticks.has_pending_work());
+	node_aware<pure::state_source<int>> state{region_1, [](){ return 1; }};
+	node_aware<pure::state_sink<int>> state_sink{region_2};
+	state >> state_sink;
+	BOOST_CHECK(region_1.ticks.has_pending_work());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
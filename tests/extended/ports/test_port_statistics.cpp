@@ -0,0 +1,168 @@
+#include <boost/test/unit_test.hpp>
+
+#include <flexcore/infrastructure.hpp>
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace fc;
+
+namespace
+{
+/// node with one port of each kind
+class statistics_node : public tree_base_node
+{
+public:
+	static constexpr auto default_name = "statistics_node";
+
+	explicit statistics_node(const node_args& node)
+		: tree_base_node(node)
+		, out_event(this)
+		, in_event(this, [this](const std::vector<int>& v) { received += v.size(); })
+		, out_state(this, []() { return 42; })
+		, in_state(this)
+	{
+	}
+
+	event_source<std::vector<int>> out_event;
+	event_sink<std::vector<int>> in_event;
+	state_source<int> out_state;
+	state_sink<int> in_state;
+	std::size_t received = 0;
+};
+
+graph::port_counts counts_of(infrastructure& infra, const graph::graph_port_properties& port)
+{
+	return infra.get_graph().statistics().counts(port.id());
+}
+}
+
+BOOST_AUTO_TEST_SUITE(test_port_statistics)
+
+BOOST_AUTO_TEST_CASE(test_registry)
+{
+	graph::port_statistics statistics;
+	const auto id = graph::graph_port_properties(
+			"port", graph::graph_node_properties("node").get_id(),
+			graph::graph_port_properties::port_type::EVENT).id();
+
+	BOOST_CHECK_EQUAL(statistics.counts(id).fired, 0);
+	BOOST_CHECK(statistics.all_counts().empty());
+
+	auto counters = statistics.register_port(id);
+	BOOST_CHECK(counters == statistics.register_port(id));
+	counters->fired += 3;
+	counters->bytes += 12;
+	BOOST_CHECK_EQUAL(statistics.counts(id).fired, 3);
+	BOOST_CHECK_EQUAL(statistics.counts(id).bytes, 12);
+	BOOST_CHECK_EQUAL(statistics.all_counts().size(), 1);
+
+	statistics.reset();
+	BOOST_CHECK_EQUAL(statistics.counts(id).fired, 0);
+	BOOST_CHECK_EQUAL(statistics.all_counts().size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_token_size)
+{
+	BOOST_CHECK_EQUAL(token_size<int>{}(1), sizeof(int));
+	BOOST_CHECK_EQUAL(token_size<std::vector<int>>{}(std::vector<int>(3)), 3 * sizeof(int));
+	BOOST_CHECK_EQUAL(token_size<std::string>{}(std::string("abcd")), 4);
+	BOOST_CHECK_EQUAL((token_size<std::vector<std::string>>{}({"a"})), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_port_counters)
+{
+	infrastructure infra;
+	auto region_a = infra.add_region("a", thread::cycle_control::fast_tick);
+	auto region_b = infra.add_region("b", thread::cycle_control::fast_tick);
+	auto& source = infra.node_owner().make_child<statistics_node>(region_a);
+	auto& neighbour = infra.node_owner().make_child<statistics_node>(region_a);
+	auto& remote = infra.node_owner().make_child<statistics_node>(region_b);
+
+	source.out_event >> neighbour.in_event;
+	source.out_event >> remote.in_event;
+	source.out_state >> neighbour.in_state;
+	source.out_state >> remote.in_state;
+
+	source.out_event.fire(std::vector<int>(4));
+	source.out_event.fire(std::vector<int>(4));
+	region_a->ticks.switch_buffers();
+	region_b->ticks.switch_buffers();
+	region_a->ticks.in_work()();
+	region_b->ticks.in_work()();
+	BOOST_CHECK_EQUAL(neighbour.received, 8);
+	BOOST_CHECK_EQUAL(remote.received, 8);
+
+	BOOST_CHECK_EQUAL(neighbour.in_state.get(), 42);
+
+	const auto source_events = counts_of(infra, source.out_event.graph_port_info);
+	const auto sink_events = counts_of(infra, remote.in_event.graph_port_info);
+	const auto source_states = counts_of(infra, source.out_state.graph_port_info);
+	const auto sink_states = counts_of(infra, neighbour.in_state.graph_port_info);
+#ifdef FLEXCORE_ENABLE_PORT_STATISTICS
+	BOOST_CHECK_EQUAL(source_events.fired, 2);
+	BOOST_CHECK_EQUAL(source_events.bytes, 2 * 4 * sizeof(int));
+	// only the connection to the other region has a buffer.
+	BOOST_CHECK_EQUAL(source_events.buffered, 2);
+	BOOST_CHECK_EQUAL(sink_events.fired, 2);
+	BOOST_CHECK_EQUAL(sink_events.buffered, 0);
+
+	// the state_buffer to region b pulled once on its work tick.
+	BOOST_CHECK_EQUAL(source_states.pulled, 2);
+	BOOST_CHECK_EQUAL(source_states.bytes, 2 * sizeof(int));
+	BOOST_CHECK_EQUAL(sink_states.pulled, 1);
+	BOOST_CHECK_EQUAL(sink_states.buffered, 0);
+	BOOST_CHECK_EQUAL(
+			counts_of(infra, remote.in_state.graph_port_info).buffered, 0);
+	remote.in_state.get();
+	BOOST_CHECK_EQUAL(
+			counts_of(infra, remote.in_state.graph_port_info).buffered, 1);
+	BOOST_CHECK_EQUAL(infra.get_graph().statistics().all_counts().size(), 12);
+#else
+	// without instrumentation nothing is registered nor counted.
+	BOOST_CHECK_EQUAL(source_events.fired, 0);
+	BOOST_CHECK_EQUAL(sink_events.fired, 0);
+	BOOST_CHECK_EQUAL(source_states.pulled, 0);
+	BOOST_CHECK_EQUAL(sink_states.pulled, 0);
+	BOOST_CHECK(infra.get_graph().statistics().all_counts().empty());
+#endif
+}
+
+#ifndef FLEXCORE_ENABLE_PORT_STATISTICS
+BOOST_AUTO_TEST_CASE(test_probe_takes_no_space)
+{
+	using source_t = pure::event_source<int>;
+	using sink_t = pure::event_sink<int>;
+	BOOST_CHECK_EQUAL(sizeof(detail::probed_port<source_t>), sizeof(source_t));
+	BOOST_CHECK_EQUAL(sizeof(detail::probed_port<sink_t>), sizeof(sink_t));
+
+	// connections of ports only hold their buffer.
+	using connection_t = port_connection<source_t, sink_t, int>;
+	BOOST_CHECK_EQUAL(sizeof(buffered_event_connection<connection_t>),
+			sizeof(std::shared_ptr<buffer_interface<int, event_tag>>));
+}
+#endif
+
+#ifdef FLEXCORE_ENABLE_PORT_STATISTICS
+BOOST_AUTO_TEST_CASE(test_node_handler_trace)
+{
+	infrastructure infra;
+	auto region = infra.add_region("a", thread::cycle_control::fast_tick);
+	auto& source = infra.node_owner().make_child<statistics_node>(region);
+	auto& sink = infra.node_owner().make_child_named<statistics_node>(region, "traced_sink");
+	source.out_event >> sink.in_event;
+
+	profiler::get().start(16, true);
+	source.out_event.fire(std::vector<int>(1));
+	profiler::get().stop();
+
+	std::stringstream trace;
+	profiler::get().write_trace(trace);
+	BOOST_CHECK(trace.str().find("\"name\":\"traced_sink\",\"cat\":\"node\"")
+			!= std::string::npos);
+}
+#endif
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -4,6 +4,11 @@
 #include <flexcore/extended/ports/connection_buffer.hpp>
 #include <flexcore/pure/pure_ports.hpp>
 
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
 BOOST_AUTO_TEST_SUITE(test_eventbuffer)
 
 using fc::operator>>;
@@ -84,4 +89,199 @@ BOOST_AUTO_TEST_CASE(test_event_buffer)
 	}
 }
 
+namespace
+{
+/// event_buffer of ints connected to a source and a sink, which stores received events.
+struct bounded_buffer
+{
+	explicit bounded_buffer(fc::overflow_policy on_overflow, std::size_t capacity = 3,
+			std::chrono::milliseconds block_timeout = std::chrono::milliseconds(1))
+		: bounded_buffer(fc::event_buffer_policy{capacity, on_overflow, block_timeout})
+	{
+	}
+
+	explicit bounded_buffer(const fc::event_buffer_policy& policy,
+			std::shared_ptr<const fc::event_coalescing<int>> coalescing = nullptr)
+		: test_buffer(policy, std::move(coalescing))
+		, sink([this](int i) { received.push_back(i); })
+	{
+		source >> test_buffer.in();
+		test_buffer.out() >> sink;
+	}
+
+	void fire(int from, int to)
+	{
+		for (int i = from; i != to; ++i)
+			source.fire(i);
+	}
+
+	/// ticks buffer like a consumer region with the same tick rate.
+	void deliver()
+	{
+		test_buffer.switch_active_passive_tick()();
+		test_buffer.work_tick()();
+	}
+
+	fc::event_buffer<int> test_buffer;
+	std::vector<int> received;
+	fc::pure::event_source<int> source;
+	fc::pure::event_sink<int> sink;
+};
+}
+
+BOOST_AUTO_TEST_CASE(test_event_buffer_metrics)
+{
+	bounded_buffer buffer{fc::overflow_policy::drop_newest, 100};
+	buffer.fire(0, 5);
+	BOOST_CHECK_EQUAL(buffer.test_buffer.metrics().depth, 5);
+	buffer.test_buffer.switch_active_tick()();
+	buffer.fire(5, 7);
+	BOOST_CHECK_EQUAL(buffer.test_buffer.metrics().depth, 7);
+	buffer.test_buffer.switch_passive_tick()();
+	BOOST_CHECK_EQUAL(buffer.test_buffer.metrics().depth, 7);
+	buffer.test_buffer.work_tick()();
+
+	const auto metrics = buffer.test_buffer.metrics();
+	BOOST_CHECK_EQUAL(metrics.depth, 2);
+	BOOST_CHECK_EQUAL(metrics.high_watermark, 7);
+	BOOST_CHECK_EQUAL(metrics.dropped, 0);
+	BOOST_CHECK_EQUAL(buffer.received.size(), 5);
+}
+
+BOOST_AUTO_TEST_CASE(test_event_buffer_drop_newest)
+{
+	bounded_buffer buffer{fc::overflow_policy::drop_newest};
+	buffer.fire(0, 5);
+	buffer.deliver();
+	BOOST_CHECK((buffer.received == std::vector<int>{0, 1, 2}));
+	BOOST_CHECK_EQUAL(buffer.test_buffer.metrics().dropped, 2);
+	BOOST_CHECK_EQUAL(buffer.test_buffer.metrics().high_watermark, 3);
+}
+
+BOOST_AUTO_TEST_CASE(test_event_buffer_drop_oldest)
+{
+	bounded_buffer buffer{fc::overflow_policy::drop_oldest};
+	buffer.fire(0, 5);
+	buffer.deliver();
+	BOOST_CHECK((buffer.received == std::vector<int>{2, 3, 4}));
+	BOOST_CHECK_EQUAL(buffer.test_buffer.metrics().dropped, 2);
+
+	// the oldest events waiting in the middle buffer are dropped first.
+	buffer.received.clear();
+	buffer.fire(10, 12);
+	buffer.test_buffer.switch_active_tick()();
+	buffer.fire(12, 14);
+	buffer.test_buffer.switch_active_tick()();
+	buffer.test_buffer.switch_passive_tick()();
+	buffer.test_buffer.work_tick()();
+	BOOST_CHECK((buffer.received == std::vector<int>{11, 12, 13}));
+	BOOST_CHECK_EQUAL(buffer.test_buffer.metrics().dropped, 3);
+}
+
+BOOST_AUTO_TEST_CASE(test_event_buffer_block)
+{
+	bounded_buffer buffer{fc::overflow_policy::block, 1, std::chrono::seconds(10)};
+	buffer.fire(0, 1);
+	buffer.test_buffer.switch_active_tick()();
+
+	// the producer waits until the consumer switches its buffers.
+	std::thread producer{[&buffer]() { buffer.fire(1, 2); }};
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	buffer.test_buffer.switch_passive_tick()();
+	producer.join();
+	buffer.test_buffer.work_tick()();
+	buffer.deliver();
+	BOOST_CHECK((buffer.received == std::vector<int>{0, 1}));
+	BOOST_CHECK_EQUAL(buffer.test_buffer.metrics().dropped, 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_event_buffer_block_timeout)
+{
+	// without consumer the producer gives up after block_timeout.
+	bounded_buffer buffer{fc::overflow_policy::block, 1};
+	buffer.fire(0, 2);
+	BOOST_CHECK_EQUAL(buffer.test_buffer.metrics().dropped, 1);
+	buffer.deliver();
+	BOOST_CHECK((buffer.received == std::vector<int>{0}));
+}
+
+BOOST_AUTO_TEST_CASE(test_coalesce_latest)
+{
+	bounded_buffer buffer{fc::event_buffer_policy{}, fc::keep_latest<int>()};
+	buffer.fire(0, 5);
+	BOOST_CHECK_EQUAL(buffer.test_buffer.metrics().depth, 1);
+	buffer.deliver();
+	BOOST_CHECK((buffer.received == std::vector<int>{4}));
+	BOOST_CHECK_EQUAL(buffer.test_buffer.metrics().coalesced, 4);
+	BOOST_CHECK_EQUAL(buffer.test_buffer.metrics().dropped, 0);
+
+	// events of several ticks of the sending region are coalesced until they are delivered.
+	buffer.received.clear();
+	buffer.fire(10, 12);
+	buffer.test_buffer.switch_active_tick()();
+	buffer.fire(12, 14);
+	buffer.test_buffer.switch_active_tick()();
+	buffer.test_buffer.switch_passive_tick()();
+	buffer.test_buffer.work_tick()();
+	BOOST_CHECK((buffer.received == std::vector<int>{13}));
+}
+
+BOOST_AUTO_TEST_CASE(test_coalesce_latest_per_key)
+{
+	bounded_buffer buffer{fc::event_buffer_policy{},
+			fc::keep_latest_per_key<int>([](int i) { return i % 3; })};
+	buffer.fire(0, 8);
+	buffer.deliver();
+	BOOST_CHECK((buffer.received == std::vector<int>{6, 7, 5}));
+	BOOST_CHECK_EQUAL(buffer.test_buffer.metrics().coalesced, 5);
+}
+
+BOOST_AUTO_TEST_CASE(test_coalesce_fold)
+{
+	bounded_buffer buffer{fc::event_buffer_policy{}, fc::fold_events<int>(std::plus<int>{})};
+	buffer.fire(1, 5);
+	buffer.test_buffer.switch_active_passive_tick()();
+	buffer.fire(5, 6);
+	buffer.deliver();
+	BOOST_CHECK((buffer.received == std::vector<int>{15}));
+
+	// the folded event is removed on delivery, the next delivery starts a new fold.
+	buffer.fire(1, 3);
+	buffer.deliver();
+	BOOST_CHECK((buffer.received == std::vector<int>{15, 3}));
+}
+
+BOOST_AUTO_TEST_CASE(test_event_buffer_block_single_tick)
+{
+	// events of a single tick of the producer can not be taken by the consumer,
+	// thus they are dropped without waiting once they fill the buffer.
+	bounded_buffer buffer{fc::overflow_policy::block, 4, std::chrono::seconds(10)};
+	const auto start = std::chrono::steady_clock::now();
+	buffer.fire(0, 100);
+	BOOST_CHECK(std::chrono::steady_clock::now() - start < std::chrono::seconds(1));
+	BOOST_CHECK_EQUAL(buffer.test_buffer.metrics().dropped, 96);
+	buffer.deliver();
+	BOOST_CHECK((buffer.received == std::vector<int>{0, 1, 2, 3}));
+}
+
+BOOST_AUTO_TEST_CASE(test_void_event_buffer_bounded)
+{
+	fc::event_buffer<void> test_buffer{
+			fc::event_buffer_policy{2, fc::overflow_policy::drop_oldest,
+					std::chrono::milliseconds{10}}};
+	int received = 0;
+	fc::pure::event_source<void> source;
+	fc::pure::event_sink<void> sink{[&received]() { ++received; }};
+	source >> test_buffer.in();
+	test_buffer.out() >> sink;
+
+	for (int i = 0; i != 5; ++i)
+		source.fire();
+	test_buffer.switch_active_passive_tick()();
+	test_buffer.work_tick()();
+	BOOST_CHECK_EQUAL(received, 2);
+	BOOST_CHECK_EQUAL(test_buffer.metrics().dropped, 3);
+	BOOST_CHECK_EQUAL(test_buffer.metrics().high_watermark, 2);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,60 @@
+#include "allocation_counter.hpp"
+
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+thread_local std::size_t allocations = 0;
+
+void* counted_allocation(std::size_t size)
+{
+	++allocations;
+	if (void* memory = std::malloc(size == 0 ? 1 : size))
+		return memory;
+	throw std::bad_alloc{};
+}
+}
+
+namespace fc
+{
+namespace tests
+{
+
+std::size_t nr_of_allocations()
+{
+	return allocations;
+}
+
+}
+}
+
+void* operator new(std::size_t size)
+{
+	return counted_allocation(size);
+}
+
+void* operator new[](std::size_t size)
+{
+	return counted_allocation(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
@@ -0,0 +1,22 @@
+#ifndef TESTS_NODES_ALLOCATION_COUNTER_HPP_
+#define TESTS_NODES_ALLOCATION_COUNTER_HPP_
+
+#include <cstddef>
+
+namespace fc
+{
+namespace tests
+{
+
+/**
+ * \brief number of calls of global operator new in the calling thread since it started.
+ *
+ * The test executable replaces the global operator new to count allocations.
+ * Take the difference before and after the code checked.
+ */
+std::size_t nr_of_allocations();
+
+}
+}
+
+#endif /* TESTS_NODES_ALLOCATION_COUNTER_HPP_ */
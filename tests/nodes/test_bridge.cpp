@@ -0,0 +1,167 @@
+#include <boost/test/unit_test.hpp>
+
+#include <flexcore/extended/nodes/bridge.hpp>
+
+#include "owning_node.hpp"
+
+#include <cereal/archives/binary.hpp>
+
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace fc;
+
+namespace
+{
+constexpr auto timeout = std::chrono::seconds(5);
+
+net::endpoint localhost(net::protocol transport, std::uint16_t port = 0)
+{
+	return net::endpoint{transport, "127.0.0.1", port};
+}
+
+/// runs work ticks of region until pred is true or the timeout has passed.
+template <class pred_t>
+bool work_until(parallel_region& region, pred_t pred)
+{
+	const auto deadline = std::chrono::steady_clock::now() + timeout;
+	while (!pred() && std::chrono::steady_clock::now() < deadline)
+	{
+		region.ticks.in_work()();
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	return pred();
+}
+
+void test_events_over(net::protocol transport)
+{
+	tests::owning_node root{};
+	auto& in = root.make_child<event_bridge_in<int, cereal::BinaryInputArchive>>(
+			localhost(transport));
+	auto& out = root.make_child<event_bridge_out<int, cereal::BinaryOutputArchive>>(
+			localhost(transport, in.connection().local_port()));
+
+	std::vector<int> received;
+	in.out() >> [&received](int i) { received.push_back(i); };
+
+	pure::event_source<int> source;
+	source >> out.in();
+	source.fire(1);
+	source.fire(2);
+	source.fire(3);
+	BOOST_CHECK(received.empty());
+	root.region()->ticks.switch_buffers();
+	out.flush();
+
+	BOOST_CHECK(work_until(*root.region(), [&]() { return received.size() == 3; }));
+	BOOST_CHECK((received == std::vector<int>{1, 2, 3}));
+
+	source.fire(4);
+	root.region()->ticks.switch_buffers();
+	BOOST_CHECK(work_until(*root.region(), [&]() { return received.size() == 4; }));
+	BOOST_CHECK_EQUAL(received.back(), 4);
+}
+}
+
+BOOST_AUTO_TEST_SUITE(test_bridge)
+
+BOOST_AUTO_TEST_CASE(test_batch_encoding)
+{
+	const std::vector<std::string> tokens{"a", "", std::string(1000, 'x'), std::string(3, '\0')};
+	const auto batch = net::encode_batch(tokens);
+	BOOST_CHECK(net::decode_batch(batch) == tokens);
+	BOOST_CHECK(net::decode_batch(net::encode_batch({})).empty());
+
+	BOOST_CHECK_THROW(net::decode_batch(batch.substr(0, batch.size() - 1)), std::runtime_error);
+	BOOST_CHECK_THROW(net::decode_batch(batch + "x"), std::runtime_error);
+	BOOST_CHECK_THROW(net::decode_batch("ab"), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_event_bridge_tcp)
+{
+	test_events_over(net::protocol::tcp);
+}
+
+BOOST_AUTO_TEST_CASE(test_event_bridge_udp)
+{
+	test_events_over(net::protocol::udp);
+}
+
+BOOST_AUTO_TEST_CASE(test_one_message_per_tick)
+{
+	net::bridge_receiver receiver{localhost(net::protocol::tcp)};
+	tests::owning_node root{};
+	auto& out = root.make_child<event_bridge_out<int, cereal::BinaryOutputArchive>>(
+			localhost(net::protocol::tcp, receiver.local_port()));
+	pure::event_source<int> source;
+	source >> out.in();
+
+	for (int i = 0; i < 100; ++i)
+		source.fire(i);
+	root.region()->ticks.switch_buffers();
+	// no events, no message
+	root.region()->ticks.switch_buffers();
+	out.flush();
+
+	BOOST_REQUIRE(receiver.wait_for_frame(timeout));
+	std::vector<std::string> messages;
+	receiver.take_all([&messages](const std::string& m) { messages.push_back(m); });
+	BOOST_REQUIRE_EQUAL(messages.size(), 1);
+	BOOST_CHECK_EQUAL(net::decode_batch(messages.front()).size(), 100);
+}
+
+BOOST_AUTO_TEST_CASE(test_backpressure)
+{
+	net::bridge_receiver receiver{localhost(net::protocol::tcp), 2};
+	net::bridge_sender sender{localhost(net::protocol::tcp, receiver.local_port()), 2};
+
+	// much more data than the socket buffers and both queues can hold.
+	const std::string frame(1 << 20, 'x');
+	constexpr int nr_frames = 32;
+	std::thread producer([&]()
+			{
+				for (int i = 0; i < nr_frames; ++i)
+					sender.send(frame);
+				sender.flush();
+			});
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	// the sender is blocked by the receiver, which did not take any frames.
+	BOOST_CHECK_LT(sender.nr_of_frames_sent(), nr_frames);
+
+	int received = 0;
+	const auto deadline = std::chrono::steady_clock::now() + timeout;
+	while (received < nr_frames && std::chrono::steady_clock::now() < deadline)
+	{
+		receiver.wait_for_frame(std::chrono::milliseconds(10));
+		receiver.take_all([&](const std::string& m) { received += (m == frame); });
+	}
+	producer.join();
+	BOOST_CHECK_EQUAL(received, nr_frames);
+	BOOST_CHECK_EQUAL(sender.nr_of_frames_sent(), nr_frames);
+}
+
+BOOST_AUTO_TEST_CASE(test_state_bridge)
+{
+	tests::owning_node root{};
+	auto& in = root.make_child<state_bridge_in<int, cereal::BinaryInputArchive>>(
+			localhost(net::protocol::tcp), -1);
+	auto& out = root.make_child<state_bridge_out<int, cereal::BinaryOutputArchive>>(
+			localhost(net::protocol::tcp, in.connection().local_port()));
+
+	int state = 0;
+	pure::state_source<int> source{[&state]() { return state; }};
+	source >> out.in();
+	pure::state_sink<int> sink;
+	in.out() >> sink;
+
+	BOOST_CHECK_EQUAL(sink.get(), -1);
+	state = 42;
+	BOOST_CHECK(work_until(*root.region(), [&]() { return sink.get() == 42; }));
+	state = 43;
+	BOOST_CHECK(work_until(*root.region(), [&]() { return sink.get() == 43; }));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -6,6 +6,7 @@
 #include <flexcore/pure/state_sink.hpp>
 #include <flexcore/pure/pure_node.hpp>
 
+#include "allocation_counter.hpp"
 #include "owning_node.hpp"
 
 using namespace fc;
@@ -105,6 +106,48 @@ BOOST_AUTO_TEST_CASE(test_hold_last)
 	BOOST_CHECK_EQUAL(sink.get(), 1);
 }
 
+BOOST_AUTO_TEST_CASE(test_hold_last_snapshot)
+{
+	tests::owning_node root{};
+
+	auto& buffer = root.make_child<hold_last<std::vector<int>, tree_base_node>>(
+			std::vector<int>{});
+
+	event_source<std::vector<int>> source{&root.node()};
+	state_sink<shared<std::vector<int>>> sink{&root.node()};
+
+	source >> buffer.in();
+	buffer.snapshot() >> sink;
+	BOOST_CHECK(sink.get().get().empty());
+
+	source.fire(std::vector<int>{1, 2});
+	const auto first = sink.get();
+	BOOST_CHECK(first.get() == (std::vector<int>{1, 2}));
+	BOOST_CHECK_EQUAL(&sink.get().get(), &first.get());
+
+	source.fire(std::vector<int>{3});
+	BOOST_CHECK(sink.get().get() == std::vector<int>{3});
+	BOOST_CHECK(first.get() == (std::vector<int>{1, 2}));
+}
+
+BOOST_AUTO_TEST_CASE(test_hold_last_without_snapshot)
+{
+	tests::owning_node root{};
+
+	auto& buffer = root.make_child<hold_last<int, tree_base_node>>(0);
+	event_source<int> source{&root.node()};
+	state_sink<int> sink{&root.node()};
+	source >> buffer.in();
+	buffer.out() >> sink;
+
+	// without pulls of snapshot, events are stored without allocations.
+	const auto allocations = tests::nr_of_allocations();
+	for (int i = 1; i != 10; ++i)
+		source.fire(i);
+	BOOST_CHECK_EQUAL(tests::nr_of_allocations(), allocations);
+	BOOST_CHECK_EQUAL(sink.get(), 9);
+}
+
 BOOST_AUTO_TEST_CASE(test_hold_n)
 {
 	tests::owning_node root{};
@@ -0,0 +1,165 @@
+#include <boost/test/unit_test.hpp>
+
+#include <flexcore/extended/nodes/recorder.hpp>
+#include <flexcore/pure/pure_node.hpp>
+
+#include "owning_node.hpp"
+
+#include <cereal/archives/binary.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <vector>
+
+using namespace fc;
+
+namespace
+{
+struct raw_record
+{
+	std::int64_t timestamp;
+	std::string payload;
+};
+
+/// reads token file with plain file io, to check the format independent of the writer.
+std::vector<raw_record> read_records(const std::string& file_name)
+{
+	namespace fmt = recording::format;
+	std::ifstream file{file_name, std::ios::binary};
+	std::vector<char> content{std::istreambuf_iterator<char>(file),
+			std::istreambuf_iterator<char>()};
+	BOOST_REQUIRE(content.size() >= sizeof(fmt::file_header));
+
+	fmt::file_header header;
+	std::memcpy(&header, content.data(), sizeof(header));
+	BOOST_CHECK(std::equal(std::begin(fmt::magic), std::end(fmt::magic), header.magic));
+	BOOST_CHECK_EQUAL(header.version, fmt::version);
+
+	std::vector<raw_record> result;
+	for (auto offset = header.first_chunk; offset < content.size();)
+	{
+		fmt::chunk_header chunk;
+		std::memcpy(&chunk, content.data() + offset, sizeof(chunk));
+		BOOST_REQUIRE(chunk.size > 0);
+		for (auto pos = offset + sizeof(chunk); pos < offset + chunk.used;)
+		{
+			fmt::record_header record;
+			std::memcpy(&record, content.data() + pos, sizeof(record));
+			const auto* payload = content.data() + pos + sizeof(record);
+			result.push_back({record.timestamp, std::string(payload, record.size)});
+			pos += fmt::record_size(record.size);
+		}
+		offset += chunk.size;
+	}
+	return result;
+}
+
+template <class data_t>
+data_t deserialize(const std::string& payload)
+{
+	std::istringstream stream{payload};
+	data_t result;
+	cereal::BinaryInputArchive{stream}(result);
+	return result;
+}
+
+const std::string test_file = "test_recorder.rec";
+}
+
+BOOST_AUTO_TEST_SUITE(test_recorder)
+
+BOOST_AUTO_TEST_CASE(test_token_file_writer_chunks)
+{
+	{
+		// tiny chunks force records into multiple and oversized chunks
+		recording::token_file_writer writer{test_file, 1};
+		const auto t = virtual_clock::steady::time_point{};
+		writer.append(t + std::chrono::seconds(1), "first");
+		writer.append(t + std::chrono::seconds(2), std::string(10000, 'x'));
+		writer.append(t + std::chrono::seconds(3), "");
+		writer.flush();
+		BOOST_CHECK_EQUAL(writer.nr_of_records(), 3);
+	}
+
+	const auto records = read_records(test_file);
+	BOOST_REQUIRE_EQUAL(records.size(), 3);
+	BOOST_CHECK_EQUAL(records[0].payload, "first");
+	BOOST_CHECK_EQUAL(records[1].payload.size(), 10000);
+	BOOST_CHECK(records[2].payload.empty());
+	BOOST_CHECK_EQUAL(records[2].timestamp,
+			std::chrono::nanoseconds(std::chrono::seconds(3)).count());
+	std::remove(test_file.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(test_event_recorder)
+{
+	tests::owning_node root{};
+	using recorder_t = event_recorder<int, cereal::BinaryOutputArchive>;
+	auto& recorder = root.make_child<recorder_t>(test_file);
+
+	pure::event_source<int> source;
+	std::vector<int> received;
+	source >> recorder.in();
+	recorder.out() >> [&received](int i){ received.push_back(i); };
+
+	for (int i = 0; i < 100; ++i)
+		source.fire(i);
+	recorder.flush();
+
+	BOOST_CHECK_EQUAL(received.size(), 100);
+	const auto records = read_records(test_file);
+	BOOST_REQUIRE_EQUAL(records.size(), 100);
+	for (int i = 0; i < 100; ++i)
+	{
+		BOOST_CHECK_EQUAL(deserialize<int>(records[i].payload), i);
+		BOOST_CHECK_EQUAL(records[i].timestamp,
+				virtual_clock::steady::now().time_since_epoch().count());
+	}
+	std::remove(test_file.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(test_void_event_recorder)
+{
+	event_recorder<void, cereal::BinaryOutputArchive, pure::pure_node> recorder{test_file};
+	pure::event_source<void> source;
+	int received = 0;
+	source >> recorder.in();
+	recorder.out() >> [&received](){ ++received; };
+
+	source.fire();
+	source.fire();
+	recorder.flush();
+
+	BOOST_CHECK_EQUAL(received, 2);
+	BOOST_CHECK_EQUAL(read_records(test_file).size(), 2);
+	std::remove(test_file.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(test_state_recorder)
+{
+	tests::owning_node root{};
+	using recorder_t = state_recorder<double, cereal::BinaryOutputArchive>;
+	auto& recorder = root.make_child<recorder_t>(test_file);
+
+	double state = 1.5;
+	pure::state_sink<double> sink;
+	[&state](){ return state; } >> recorder.in();
+	recorder.out() >> sink;
+
+	BOOST_CHECK_EQUAL(sink.get(), 1.5);
+	state = 2.5;
+	BOOST_CHECK_EQUAL(sink.get(), 2.5);
+	recorder.flush();
+
+	const auto records = read_records(test_file);
+	BOOST_REQUIRE_EQUAL(records.size(), 2);
+	BOOST_CHECK_EQUAL(deserialize<double>(records[0].payload), 1.5);
+	BOOST_CHECK_EQUAL(deserialize<double>(records[1].payload), 2.5);
+	std::remove(test_file.c_str());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,158 @@
+#include <boost/test/unit_test.hpp>
+
+#include <flexcore/extended/nodes/recorder.hpp>
+#include <flexcore/extended/nodes/replay.hpp>
+#include <flexcore/pure/pure_node.hpp>
+
+#include "owning_node.hpp"
+
+#include <cereal/archives/binary.hpp>
+
+#include <cstdio>
+#include <vector>
+
+using namespace fc;
+
+namespace
+{
+using clock = master_clock<std::centi>;
+constexpr auto tick = std::chrono::milliseconds(10);
+const std::string test_file = "test_replay.rec";
+
+/// writes ints 0..n-1 with one token every tick starting at start.
+void write_ints(int n, virtual_clock::steady::time_point start, std::size_t chunk_size)
+{
+	recording::token_file_writer writer{test_file, chunk_size};
+	single_object_serializer<int, cereal::BinaryOutputArchive> serialize;
+	for (int i = 0; i < n; ++i)
+		writer.append(start + i * tick, serialize(i));
+}
+}
+
+BOOST_AUTO_TEST_SUITE(test_replay)
+
+BOOST_AUTO_TEST_CASE(test_reader_seek)
+{
+	const auto start = virtual_clock::steady::time_point{} + std::chrono::seconds(1);
+	// small chunks, to check seeking across many chunks.
+	write_ints(1000, start, 1);
+
+	single_object_deserializer<int, cereal::BinaryInputArchive> deserialize;
+	recording::token_file_reader reader{test_file};
+	BOOST_CHECK_EQUAL(reader.nr_of_records(), 1000);
+
+	auto c = reader.begin();
+	BOOST_CHECK_EQUAL(deserialize(reader.read(c).payload()), 0);
+
+	c = reader.seek(start + 500 * tick);
+	BOOST_CHECK_EQUAL(deserialize(reader.read(c).payload()), 500);
+	BOOST_CHECK(reader.read(c).timestamp == start + 500 * tick);
+
+	// between two records
+	c = reader.seek(start + 500 * tick + std::chrono::milliseconds(1));
+	BOOST_CHECK_EQUAL(deserialize(reader.read(c).payload()), 501);
+
+	c = reader.seek(start - std::chrono::seconds(1));
+	BOOST_CHECK_EQUAL(deserialize(reader.read(c).payload()), 0);
+
+	BOOST_CHECK(reader.at_end(reader.seek(start + 1000 * tick)));
+
+	int count = 0;
+	for (c = reader.begin(); !reader.at_end(c); reader.advance(c))
+		BOOST_CHECK_EQUAL(deserialize(reader.read(c).payload()), count++);
+	BOOST_CHECK_EQUAL(count, 1000);
+	std::remove(test_file.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(test_event_replay)
+{
+	const auto start = virtual_clock::steady::now() + tick;
+	write_ints(10, start, recording::token_file_writer::default_chunk_size);
+
+	tests::owning_node root{};
+	auto& replay = root.make_child<event_replay<int, cereal::BinaryInputArchive>>(test_file);
+	std::vector<int> received;
+	replay.out() >> [&received](int i){ received.push_back(i); };
+
+	auto work = root.region()->ticks.in_work();
+	work();
+	BOOST_CHECK(received.empty());
+
+	clock::advance();
+	work();
+	BOOST_CHECK_EQUAL(received.size(), 1);
+
+	// several ticks pass before the next work tick, all due events are fired.
+	clock::advance();
+	clock::advance();
+	clock::advance();
+	work();
+	BOOST_CHECK((received == std::vector<int>{0, 1, 2, 3}));
+
+	replay.seek(start + 8 * tick);
+	work();
+	BOOST_CHECK((received == std::vector<int>{0, 1, 2, 3, 8}));
+	clock::advance();
+	work();
+	BOOST_CHECK((received == std::vector<int>{0, 1, 2, 3, 8, 9}));
+	BOOST_CHECK(replay.done());
+	std::remove(test_file.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(test_state_replay)
+{
+	const auto start = virtual_clock::steady::now() + tick;
+	write_ints(10, start, recording::token_file_writer::default_chunk_size);
+
+	tests::owning_node root{};
+	using replay_t = state_replay<int, cereal::BinaryInputArchive>;
+	auto& replay = root.make_child<replay_t>(test_file, -1);
+	pure::state_sink<int> sink;
+	replay.out() >> sink;
+
+	auto work = root.region()->ticks.in_work();
+	work();
+	BOOST_CHECK_EQUAL(sink.get(), -1);
+
+	clock::advance();
+	work();
+	BOOST_CHECK_EQUAL(sink.get(), 0);
+
+	clock::advance();
+	clock::advance();
+	work();
+	BOOST_CHECK_EQUAL(sink.get(), 2);
+	BOOST_CHECK_EQUAL(sink.get(), 2);
+	std::remove(test_file.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(test_record_and_replay)
+{
+	const auto recording_start = virtual_clock::steady::now();
+	{
+		event_recorder<void, cereal::BinaryOutputArchive, pure::pure_node> recorder{test_file};
+		pure::event_source<void> source;
+		source >> recorder.in();
+		source.fire();
+		clock::advance();
+		source.fire();
+		source.fire();
+	}
+	clock::advance();
+
+	tests::owning_node root{};
+	auto& replay = root.make_child<event_replay<void, cereal::BinaryInputArchive>>(test_file);
+	int received = 0;
+	replay.out() >> [&received](){ ++received; };
+
+	// replay what was recorded before, starting now.
+	replay.seek(recording_start);
+	root.region()->ticks.in_work()();
+	BOOST_CHECK_EQUAL(received, 1);
+	clock::advance();
+	root.region()->ticks.in_work()();
+	BOOST_CHECK_EQUAL(received, 3);
+	std::remove(test_file.c_str());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -2,8 +2,11 @@
 
 #include <flexcore/extended/nodes/state_nodes.hpp>
 
+#include "allocation_counter.hpp"
 #include "owning_node.hpp"
 
+#include <vector>
+
 BOOST_AUTO_TEST_SUITE( test_state_nodes )
 
 using fc::operator>>;
@@ -87,4 +90,48 @@ BOOST_AUTO_TEST_CASE(test_current_state)
 	BOOST_CHECK_EQUAL(test_node.out()(), 2);
 }
 
+BOOST_AUTO_TEST_CASE( test_current_state_snapshot )
+{
+	fc::tests::owning_node root{};
+	auto region = std::make_shared<fc::parallel_region>("MyRegion",
+			fc::thread::cycle_control::fast_tick);
+	auto& test_node = root.make_child<fc::current_state<std::vector<int>>>(region);
+
+	std::vector<int> test_val{1, 2, 3};
+	auto source = [&test_val](){ return test_val;};
+	source >> test_node.in();
+	region->ticks.work.fire();
+
+	// all pulls within a tick share one snapshot.
+	const auto first = test_node.snapshot()();
+	BOOST_CHECK(first.get() == test_val);
+	BOOST_CHECK_EQUAL(&test_node.snapshot()().get(), &first.get());
+
+	// held snapshots are not changed by later ticks.
+	test_val = {4};
+	region->ticks.work.fire();
+	const auto second = test_node.snapshot()();
+	BOOST_CHECK(second.get() == test_val);
+	BOOST_CHECK(first.get() == (std::vector<int>{1, 2, 3}));
+}
+
+BOOST_AUTO_TEST_CASE( test_current_state_without_snapshot )
+{
+	fc::tests::owning_node root{};
+	auto region = std::make_shared<fc::parallel_region>("MyRegion",
+			fc::thread::cycle_control::fast_tick);
+	auto& test_node = root.make_child<fc::current_state<int>>(region);
+
+	int test_val = 0;
+	[&test_val](){ return test_val;} >> test_node.in();
+	region->ticks.work.fire();
+
+	// without pulls of snapshot, the state is cached without allocations.
+	const auto allocations = fc::tests::nr_of_allocations();
+	for (test_val = 1; test_val != 10; ++test_val)
+		region->ticks.work.fire();
+	BOOST_CHECK_EQUAL(fc::tests::nr_of_allocations(), allocations);
+	BOOST_CHECK_EQUAL(test_node.out()(), 9);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
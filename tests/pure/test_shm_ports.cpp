@@ -0,0 +1,145 @@
+#include <boost/test/unit_test.hpp>
+
+#include <flexcore/pure/shm_ports.hpp>
+#include <flexcore/pure/event_sources.hpp>
+#include <flexcore/pure/state_sources.hpp>
+#include <flexcore/core/connection.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace fc;
+
+namespace
+{
+struct sample
+{
+	int id;
+	double value;
+};
+
+/// unique shared memory name per process, so that parallel test runs don't collide.
+std::string shm_name(const std::string& name)
+{
+	return "/fc_test_" + name + "_" + std::to_string(::getpid());
+}
+}
+
+BOOST_AUTO_TEST_SUITE(test_shm_ports)
+
+BOOST_AUTO_TEST_CASE(test_port_traits)
+{
+	static_assert(is_passive_sink<pure::shm_event_sink<int>>{}, "");
+	static_assert(is_active_source<pure::shm_event_source<int>>{}, "");
+	static_assert(is_active_sink<pure::shm_state_sink<int>>{}, "");
+	static_assert(is_passive_source<pure::shm_state_source<int>>{}, "");
+}
+
+BOOST_AUTO_TEST_CASE(test_shm_events)
+{
+	const auto name = shm_name("events");
+	pure::shm_event_sink<sample> sink{name, 4};
+	pure::shm_event_source<sample> source{name};
+
+	pure::event_source<sample> producer;
+	producer >> [](sample s) { s.value *= 2; return s; } >> sink;
+
+	std::vector<sample> received;
+	source >> [&received](const sample& s) { received.push_back(s); };
+
+	BOOST_CHECK_EQUAL(source.poll(), 0);
+	producer.fire(sample{1, 1.0});
+	producer.fire(sample{2, 2.0});
+	BOOST_CHECK(received.empty());
+
+	pure::event_source<void> tick;
+	tick >> source.poll_tick();
+	tick.fire();
+	BOOST_REQUIRE_EQUAL(received.size(), 2);
+	BOOST_CHECK_EQUAL(received[1].id, 2);
+	BOOST_CHECK_EQUAL(received[1].value, 4.0);
+
+	// queue holds four events, the rest is dropped.
+	for (int i = 0; i < 6; ++i)
+		producer.fire(sample{i, 0.0});
+	BOOST_CHECK_EQUAL(sink.nr_dropped(), 2);
+	BOOST_CHECK_EQUAL(source.poll(), 4);
+	BOOST_CHECK_EQUAL(received.back().id, 3);
+}
+
+BOOST_AUTO_TEST_CASE(test_shm_state)
+{
+	const auto name = shm_name("state");
+	pure::shm_state_sink<sample> sink{name};
+	pure::shm_state_source<sample> source{name, sample{-1, 0.0}};
+
+	int counter = 0;
+	pure::state_source<sample> producer{[&counter]() { return sample{++counter, 0.5}; }};
+	producer >> sink;
+	pure::state_sink<int> consumer;
+	source >> [](const sample& s) { return s.id; } >> consumer;
+
+	BOOST_CHECK_EQUAL(consumer.get(), -1);
+	sink.publish();
+	BOOST_CHECK_EQUAL(consumer.get(), 1);
+	BOOST_CHECK_EQUAL(consumer.get(), 1);
+	sink.publish_tick()();
+	BOOST_CHECK_EQUAL(consumer.get(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(test_shm_errors)
+{
+	const auto name = shm_name("errors");
+	BOOST_CHECK_THROW(pure::shm_event_source<int>{name}, std::system_error);
+
+	pure::shm_event_sink<int> sink{name};
+	BOOST_CHECK_THROW(pure::shm_event_sink<int>{name}, std::system_error);
+	BOOST_CHECK_THROW(pure::shm_event_source<double>{name}, std::runtime_error);
+	BOOST_CHECK_THROW(pure::shm_state_source<int>{name}, std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_shm_between_processes)
+{
+	const auto name = shm_name("processes");
+	constexpr int nr_events = 10000;
+	pure::shm_event_sink<int> sink{name, 64};
+
+	const auto child = ::fork();
+	BOOST_REQUIRE(child >= 0);
+	if (child == 0)
+	{
+		// child: receive all events and report success through the exit code.
+		pure::shm_event_source<int> source{name};
+		int expected = 0;
+		bool in_order = true;
+		source >> [&](int i) { in_order = in_order && i == expected++; };
+		while (expected < nr_events)
+			source.poll();
+		::_exit(in_order ? 0 : 1);
+	}
+
+	for (int i = 0; i < nr_events; ++i)
+	{
+		// retry until the child made room in the queue.
+		auto dropped = sink.nr_dropped();
+		sink(i);
+		while (sink.nr_dropped() != dropped)
+		{
+			::usleep(10);
+			dropped = sink.nr_dropped();
+			sink(i);
+		}
+	}
+
+	int status = 0;
+	BOOST_REQUIRE_EQUAL(::waitpid(child, &status, 0), child);
+	BOOST_CHECK(WIFEXITED(status));
+	BOOST_CHECK_EQUAL(WEXITSTATUS(status), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
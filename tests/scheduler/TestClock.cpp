@@ -5,6 +5,9 @@
 #include <flexcore/scheduler/clock.hpp>
 #include <boost/test/unit_test.hpp>
 
+#include <thread>
+#include <vector>
+
 
 using namespace fc;
 namespace chr = std::chrono;
@@ -88,4 +91,45 @@ BOOST_AUTO_TEST_CASE(test_time_t_conversion)
 			== chr::time_point_cast<chr::seconds>(back_converted));
 }
 
+BOOST_AUTO_TEST_CASE(test_clock_contexts)
+{
+	const auto process_time = virtual_clock::steady::now();
+	clock_context first;
+	clock_context second;
+	{
+		const clock_context::scope bind_first{first};
+		master::advance();
+		BOOST_CHECK(virtual_clock::steady::now().time_since_epoch() == one_tick);
+		{
+			const clock_context::scope bind_second{second};
+			BOOST_CHECK(virtual_clock::steady::now().time_since_epoch() == virtual_clock::duration::zero());
+		}
+		// the previous context is restored
+		BOOST_CHECK(virtual_clock::steady::now().time_since_epoch() == one_tick);
+	}
+	BOOST_CHECK(virtual_clock::steady::now() == process_time);
+	BOOST_CHECK(clock_context::process_context() == clock_context::process_context());
+}
+
+BOOST_AUTO_TEST_CASE(test_parallel_contexts)
+{
+	constexpr int nr_of_threads = 4;
+	std::vector<virtual_clock::duration> results(nr_of_threads);
+	std::vector<std::thread> threads;
+	for (int i = 0; i != nr_of_threads; ++i)
+		threads.emplace_back([&results, i]()
+				{
+					clock_context context;
+					const clock_context::scope bind{context};
+					for (int j = 0; j != 100 * (i + 1); ++j)
+						master::advance();
+					results[i] = virtual_clock::steady::now().time_since_epoch();
+				});
+	for (auto& thread : threads)
+		thread.join();
+
+	for (int i = 0; i != nr_of_threads; ++i)
+		BOOST_CHECK(results[i] == one_tick * 100 * (i + 1));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
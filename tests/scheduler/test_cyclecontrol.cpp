@@ -7,6 +7,7 @@
 
 #include <flexcore/scheduler/cyclecontrol.hpp>
 #include <flexcore/scheduler/parallelscheduler.hpp>
+#include <flexcore/scheduler/serialschedulers.hpp>
 #include <boost/test/unit_test.hpp>
 #include <boost/test/floating_point_comparison.hpp>
 
@@ -14,6 +15,7 @@
 #include <iomanip>
 #include <ctime>
 #include <future>
+#include <vector>
 #include <unistd.h>
 
 using namespace fc;
@@ -102,4 +104,394 @@ BOOST_AUTO_TEST_CASE(test_fast_main_loop)
 	BOOST_TEST_MESSAGE("Medium count: " << count_medium);
 	BOOST_TEST_MESSAGE("Slow count: " << count_slow);
 }
+
+BOOST_AUTO_TEST_CASE(test_low_jitter_main_loop)
+{
+	namespace sched = fc::thread;
+	sched::low_jitter_main_loop loop{std::chrono::microseconds(500)};
+	int count = 0;
+	loop.arm();
+	const auto start = wall_clock::steady::now();
+	for (int i = 0; i != 5; ++i)
+		loop.loop_body([&count]{ ++count; });
+	const auto elapsed = wall_clock::steady::now() - start;
+
+	BOOST_CHECK_EQUAL(count, 5);
+	BOOST_CHECK(elapsed >= 5 * sched::cycle_control::min_tick_length);
+	const auto errors = loop.wakeup_errors();
+	BOOST_CHECK_EQUAL(errors.ticks, 5);
+	BOOST_CHECK(errors.last >= wall_clock::steady::duration::zero());
+	BOOST_CHECK(errors.last <= errors.max);
+	BOOST_CHECK(errors.max <= errors.sum);
+	BOOST_TEST_MESSAGE("Max wake-up error: "
+			<< std::chrono::duration_cast<std::chrono::microseconds>(errors.max).count() << "us");
+
+	loop.reset_wakeup_errors();
+	BOOST_CHECK_EQUAL(loop.wakeup_errors().ticks, 0);
+}
+
+namespace
+{
+/// runs a tick of loop which stalls for 3.5 ticks.
+template <class loop_t>
+void run_stalled_tick(loop_t& loop)
+{
+	loop.arm();
+	loop.loop_body([]{
+		std::this_thread::sleep_for(fc::thread::cycle_control::min_tick_length * 3.5);
+	});
+}
+}
+
+BOOST_AUTO_TEST_CASE(test_overrun_catch_up)
+{
+	namespace sched = fc::thread;
+	sched::realtime_main_loop loop{sched::overrun_policy::catch_up};
+	run_stalled_tick(loop);
+	const auto counts = loop.overrun_counts();
+	BOOST_CHECK_EQUAL(counts.overruns, 1);
+	BOOST_CHECK(counts.max_lateness >= 2 * sched::cycle_control::min_tick_length);
+	BOOST_CHECK_EQUAL(counts.skipped_ticks, 0);
+	BOOST_CHECK(counts.slipped == wall_clock::steady::duration::zero());
+
+	// the missed ticks follow back to back
+	const auto start = wall_clock::steady::now();
+	loop.loop_body([]{});
+	BOOST_CHECK(wall_clock::steady::now() - start < sched::cycle_control::min_tick_length);
+	BOOST_CHECK_EQUAL(loop.overrun_counts().overruns, 2);
+}
+
+BOOST_AUTO_TEST_CASE(test_overrun_skip)
+{
+	namespace sched = fc::thread;
+	sched::low_jitter_main_loop loop{std::chrono::microseconds(200), sched::overrun_policy::skip};
+	int skipped = 0;
+	loop.skip_tick = [&skipped]{ ++skipped; };
+	run_stalled_tick(loop);
+	const auto counts = loop.overrun_counts();
+	BOOST_CHECK_EQUAL(counts.overruns, 1);
+	BOOST_CHECK(counts.skipped_ticks >= 2);
+	BOOST_CHECK_EQUAL(counts.skipped_ticks, skipped);
+	BOOST_CHECK_EQUAL(loop.wakeup_errors().ticks, 0);
+
+	// only the late tick runs immediately, the next waits for its deadline.
+	loop.loop_body([]{});
+	const auto start = wall_clock::steady::now();
+	loop.loop_body([]{});
+	BOOST_CHECK(wall_clock::steady::now() - start >= sched::cycle_control::min_tick_length / 2);
+	BOOST_CHECK_EQUAL(loop.overrun_counts().skipped_ticks, skipped);
+}
+
+BOOST_AUTO_TEST_CASE(test_overrun_slip)
+{
+	namespace sched = fc::thread;
+	sched::realtime_main_loop loop{sched::overrun_policy::slip};
+	int skipped = 0;
+	loop.skip_tick = [&skipped]{ ++skipped; };
+	run_stalled_tick(loop);
+	const auto counts = loop.overrun_counts();
+	BOOST_CHECK_EQUAL(counts.overruns, 1);
+	BOOST_CHECK(counts.slipped >= 2 * sched::cycle_control::min_tick_length);
+	BOOST_CHECK_EQUAL(counts.skipped_ticks, 0);
+	BOOST_CHECK_EQUAL(skipped, 0);
+
+	// the next tick starts a full tick after the stall.
+	const auto start = wall_clock::steady::now();
+	loop.loop_body([]{});
+	BOOST_CHECK(wall_clock::steady::now() - start >= sched::cycle_control::min_tick_length / 2);
+}
+
+BOOST_AUTO_TEST_CASE(test_skip_tick)
+{
+	namespace sched = fc::thread;
+	auto loop = std::make_shared<sched::realtime_main_loop>(sched::overrun_policy::skip);
+	sched::cycle_control controller{std::make_unique<sched::parallel_scheduler>(), loop};
+	int count = 0;
+	controller.add_task(sched::periodic_task{[&count]{ ++count; }}, sched::cycle_control::fast_tick);
+
+	const auto before = virtual_clock::steady::now();
+	loop->skip_tick();
+	BOOST_CHECK(virtual_clock::steady::now() - before == sched::cycle_control::min_tick_length);
+	BOOST_CHECK_EQUAL(count, 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_sliced_region_interleaves)
+{
+	namespace sched = fc::thread;
+	using cycle = sched::cycle_control;
+	std::atomic<int> slices{0};
+	std::atomic<int> fast_count{0};
+	auto slow_region = std::make_shared<parallel_region>("slow", cycle::slow_tick);
+	slow_region->ticks.add_sliced_work([&slices]
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(2));
+				return ++slices == 50 ? slice_result::done : slice_result::yield;
+			});
+
+	// a single worker thread, which would be blocked by unsliced slow work for 100ms.
+	sched::cycle_control controller{std::make_unique<sched::parallel_scheduler>(1),
+		[](auto&) { return true; }, std::make_shared<sched::afap_main_loop>()};
+	controller.add_task(sched::periodic_task{slow_region}, cycle::slow_tick);
+	controller.add_task(sched::periodic_task{[&fast_count]{ ++fast_count; }}, cycle::fast_tick);
+
+	// the virtual clock is shared, advance it until the slow tick is due.
+	while (slices.load() == 0)
+		controller.work();
+	const int fast_before = fast_count.load();
+	for (int i = 0; i != 5; ++i)
+	{
+		std::this_thread::sleep_for(cycle::min_tick_length);
+		controller.work();
+	}
+	std::this_thread::sleep_for(cycle::min_tick_length);
+	BOOST_CHECK_GE(fast_count.load() - fast_before, 3);
+	BOOST_CHECK_LT(slices.load(), 50);
+
+	while (slices.load() != 50)
+		std::this_thread::yield();
+}
+
+namespace
+{
+/// executes cycles until the start of a slow tick of the shared virtual clock.
+void work_until_slow_tick(fc::thread::cycle_control& controller)
+{
+	using cycle = fc::thread::cycle_control;
+	while (virtual_clock::steady::now().time_since_epoch() % cycle::slow_tick
+			!= virtual_clock::duration::zero())
+		controller.work();
+}
+}
+
+BOOST_AUTO_TEST_CASE(test_phase_offsets)
+{
+	namespace sched = fc::thread;
+	using cycle = sched::cycle_control;
+	std::vector<virtual_clock::duration> executed;
+	sched::cycle_control controller{std::make_unique<sched::blocking_scheduler>(),
+		[](auto&) { return true; }, std::make_shared<sched::afap_main_loop>()};
+	controller.add_task(sched::periodic_task{[&executed]
+			{
+				// the clock is advanced before tasks are executed.
+				executed.push_back(virtual_clock::steady::now().time_since_epoch()
+						- cycle::min_tick_length);
+			}}, cycle::medium_tick, 3 * cycle::min_tick_length);
+	BOOST_CHECK_THROW(controller.add_task(sched::periodic_task{[]{}}, cycle::medium_tick,
+			cycle::medium_tick), std::invalid_argument);
+	BOOST_CHECK_THROW(controller.add_task(sched::periodic_task{[]{}}, cycle::medium_tick,
+			cycle::min_tick_length / 2), std::invalid_argument);
+
+	work_until_slow_tick(controller);
+	executed.clear();
+	for (int i = 0; i != 20; ++i)
+		controller.work();
+	BOOST_CHECK_EQUAL(executed.size(), 2);
+	for (const auto time : executed)
+		BOOST_CHECK(time % cycle::medium_tick == 3 * cycle::min_tick_length);
+}
+
+BOOST_AUTO_TEST_CASE(test_distribute_phases)
+{
+	namespace sched = fc::thread;
+	using cycle = sched::cycle_control;
+	constexpr int nr_of_tasks = 10;
+	std::vector<int> executed_per_cycle;
+	int executed = 0;
+	sched::cycle_control controller{std::make_unique<sched::blocking_scheduler>(),
+		[](auto&) { return true; }, std::make_shared<sched::afap_main_loop>()};
+	for (int i = 0; i != nr_of_tasks; ++i)
+		controller.add_task(sched::periodic_task{[&executed]{ ++executed; }}, cycle::medium_tick);
+
+	// all tasks have phase zero, thus are executed in the same cycle
+	work_until_slow_tick(controller);
+	for (int i = 0; i != 10; ++i)
+	{
+		executed = 0;
+		controller.work();
+		executed_per_cycle.push_back(executed);
+	}
+	BOOST_CHECK_EQUAL(executed_per_cycle.front(), nr_of_tasks);
+
+	controller.distribute_phases();
+	executed_per_cycle.clear();
+	for (int i = 0; i != 10; ++i)
+	{
+		executed = 0;
+		controller.work();
+		executed_per_cycle.push_back(executed);
+	}
+	BOOST_CHECK((executed_per_cycle == std::vector<int>(10, 1)));
+}
+
+BOOST_AUTO_TEST_CASE(test_automatic_phases)
+{
+	namespace sched = fc::thread;
+	using cycle = sched::cycle_control;
+	std::vector<int> executed(10, 0);
+	sched::cycle_control controller{std::make_unique<sched::blocking_scheduler>(),
+		[](auto&) { return true; }, std::make_shared<sched::afap_main_loop>()};
+	int cycle_nr = 0;
+	for (int i = 0; i != 10; ++i)
+		controller.add_task(sched::periodic_task{[&executed, &cycle_nr]{ ++executed[cycle_nr]; }},
+				cycle::medium_tick);
+	controller.set_automatic_phases(true);
+
+	// phases are distributed at the start of the next slow tick,
+	// the tasks move after their run on their old phase.
+	work_until_slow_tick(controller);
+	for (int i = 0; i != 10; ++i)
+		controller.work();
+	executed.assign(10, 0);
+	for (; cycle_nr != 10; ++cycle_nr)
+		controller.work();
+	BOOST_CHECK((executed == std::vector<int>(10, 1)));
+}
+
+BOOST_AUTO_TEST_CASE(test_automatic_phases_keep_interval)
+{
+	namespace sched = fc::thread;
+	using cycle = sched::cycle_control;
+	sched::cycle_control controller{std::make_unique<sched::blocking_scheduler>(),
+		[](auto&) { return true; }, std::make_shared<sched::afap_main_loop>()};
+	int cycle_nr = 0;
+	// cycles in which each task ran, medium tasks first.
+	std::vector<std::vector<int>> runs(8);
+	for (std::size_t i = 0; i != runs.size(); ++i)
+		controller.add_task(sched::periodic_task{[&runs, &cycle_nr, i]
+				{
+					runs[i].push_back(cycle_nr);
+				}}, i < 6 ? cycle::medium_tick : cycle::slow_tick,
+				i < 6 ? 9 * cycle::min_tick_length : 90 * cycle::min_tick_length);
+	controller.set_automatic_phases(true);
+
+	work_until_slow_tick(controller);
+	for (auto& task_runs : runs)
+		task_runs.clear();
+	for (; cycle_nr != 500; ++cycle_nr)
+		controller.work();
+
+	// moves to earlier or later phases never shorten an interval below the tick.
+	for (std::size_t i = 0; i != runs.size(); ++i)
+	{
+		const int tick = i < 6 ? 10 : 100;
+		BOOST_REQUIRE_GT(runs[i].size(), 2);
+		for (std::size_t run = 1; run != runs[i].size(); ++run)
+		{
+			const auto interval = runs[i][run] - runs[i][run - 1];
+			BOOST_CHECK_GE(interval, tick);
+			BOOST_CHECK_LT(interval, 2 * tick);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(test_separate_clocks)
+{
+	namespace sched = fc::thread;
+	using cycle = sched::cycle_control;
+	const auto process_time = virtual_clock::steady::now();
+	auto make_controller = []()
+	{
+		auto controller = std::make_unique<sched::cycle_control>(
+				std::make_unique<sched::blocking_scheduler>(),
+				[](auto&) { return true; }, std::make_shared<sched::afap_main_loop>());
+		controller->set_clocks(std::make_shared<clock_context>());
+		return controller;
+	};
+	auto first = make_controller();
+	auto second = make_controller();
+	virtual_clock::duration seen_by_task{};
+	first->add_task(sched::periodic_task{[&seen_by_task]
+			{
+				seen_by_task = virtual_clock::steady::now().time_since_epoch();
+			}}, cycle::fast_tick);
+
+	for (int i = 0; i != 3; ++i)
+		first->work();
+	second->work();
+
+	BOOST_CHECK(seen_by_task == 3 * cycle::min_tick_length);
+	BOOST_CHECK(first->clocks().steady_now().time_since_epoch() == 3 * cycle::min_tick_length);
+	BOOST_CHECK(second->clocks().steady_now().time_since_epoch() == cycle::min_tick_length);
+	BOOST_CHECK(virtual_clock::steady::now() == process_time);
+}
+
+BOOST_AUTO_TEST_CASE(test_parallel_work_joins)
+{
+	namespace sched = fc::thread;
+	using cycle = sched::cycle_control;
+	using std::chrono::milliseconds;
+	auto region = std::make_shared<parallel_region>("parallel", cycle::fast_tick);
+	std::atomic<int> sequential{0};
+	std::atomic<int> running{0};
+	std::atomic<int> max_running{0};
+	std::atomic<int> finished{0};
+	region->work_tick() >> [&sequential, &finished]
+			{
+				// the sequential work tick runs before all groups.
+				BOOST_CHECK_EQUAL(finished.load(), 0);
+				++sequential;
+			};
+	for (std::size_t group = 0; group != 2; ++group)
+		region->ticks.parallel_work_tick(group) >> [&]
+				{
+					const int now_running = ++running;
+					int max = max_running.load();
+					while (now_running > max && !max_running.compare_exchange_weak(max, now_running))
+						;
+					std::this_thread::sleep_for(milliseconds(20));
+					--running;
+					++finished;
+				};
+
+	sched::cycle_control controller{std::make_unique<sched::parallel_scheduler>(2),
+		[](auto&) { return true; }, std::make_shared<sched::afap_main_loop>()};
+	controller.set_clocks(std::make_shared<clock_context>());
+	controller.add_task(sched::periodic_task{region}, cycle::fast_tick);
+
+	controller.work();
+	controller.wait_for_all_tasks();
+	// the task is only done, once both groups are joined.
+	BOOST_CHECK_EQUAL(sequential.load(), 1);
+	BOOST_CHECK_EQUAL(finished.load(), 2);
+	BOOST_CHECK_EQUAL(max_running.load(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(test_skip_quiescent_region)
+{
+	namespace sched = fc::thread;
+	using cycle = sched::cycle_control;
+	auto region = std::make_shared<parallel_region>("triggered", cycle::fast_tick);
+	region->ticks.set_run_when_triggered(true);
+	int switched = 0;
+	int worked = 0;
+	bool pending = false;
+	region->switch_tick() >> [&switched] { ++switched; };
+	// handler which only needs the work tick if pending, like an event buffer.
+	auto owner = std::make_shared<int>(0);
+	region->work_tick() >> [&worked] { ++worked; };
+	region->ticks.add_work_trigger(owner, [&pending] { return pending; });
+
+	sched::cycle_control controller{std::make_unique<sched::blocking_scheduler>(),
+		[](auto&) { return true; }, std::make_shared<sched::afap_main_loop>()};
+	controller.set_clocks(std::make_shared<clock_context>());
+	controller.add_task(sched::periodic_task{region}, cycle::fast_tick);
+
+	for (int i = 0; i != 3; ++i)
+		controller.work();
+	BOOST_CHECK_EQUAL(switched, 3);
+	BOOST_CHECK_EQUAL(worked, 0);
+	BOOST_CHECK(controller.clocks().steady_now().time_since_epoch() == 3 * cycle::min_tick_length);
+
+	pending = true;
+	controller.work();
+	BOOST_CHECK_EQUAL(worked, 1);
+
+	// without trigger the work tick has a subscriber, which needs every tick.
+	pending = false;
+	owner.reset();
+	controller.work();
+	BOOST_CHECK_EQUAL(switched, 5);
+	BOOST_CHECK_EQUAL(worked, 2);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
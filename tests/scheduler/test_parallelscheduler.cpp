@@ -9,7 +9,12 @@
 #include <flexcore/scheduler/parallelscheduler.hpp>
 #include <boost/test/unit_test.hpp>
 
+#include <atomic>
 #include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 using namespace fc;
 
@@ -127,4 +132,42 @@ BOOST_AUTO_TEST_CASE(test_main_loop)
 
 }
 
+BOOST_AUTO_TEST_CASE(test_earliest_deadline_first)
+{
+	thread::parallel_scheduler scheduler{1};
+	std::mutex order_mutex;
+	std::vector<int> order;
+	auto record = [&order, &order_mutex](int i)
+	{
+		return [&order, &order_mutex, i]()
+		{
+			std::lock_guard<std::mutex> lock(order_mutex);
+			order.push_back(i);
+		};
+	};
+
+	// block the single worker, so that all following tasks are queued.
+	std::promise<void> release;
+	std::shared_future<void> released = release.get_future().share();
+	std::atomic<bool> blocked{false};
+	scheduler.add_task([&blocked, released]() { blocked = true; released.wait(); });
+	while (!blocked)
+		std::this_thread::yield();
+
+	scheduler.add_task(record(0), thread::cycle_control::slow_tick);
+	scheduler.add_task(record(1), thread::cycle_control::medium_tick);
+	scheduler.add_task(record(2), thread::cycle_control::fast_tick);
+	scheduler.add_task(record(3), thread::cycle_control::fast_tick);
+	scheduler.add_task(record(4));
+	BOOST_CHECK_EQUAL(scheduler.nr_of_waiting_tasks(), 5);
+
+	release.set_value();
+	while (scheduler.nr_of_waiting_tasks() != 0)
+		std::this_thread::yield();
+	scheduler.stop();
+
+	// tasks without deadline are due immediately, equal deadlines keep their order.
+	BOOST_CHECK((order == std::vector<int>{4, 2, 3, 1, 0}));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -2,6 +2,8 @@
 
 #include <flexcore/scheduler/serialschedulers.hpp>
 #include <future>
+#include <stdexcept>
+#include <vector>
 
 namespace
 {
@@ -51,5 +53,36 @@ BOOST_AUTO_TEST_CASE(test_nr_of_waiting_tasks)
 	check.join();
 	BOOST_CHECK(nr_was_one);
 }
+
+BOOST_AUTO_TEST_CASE(test_tasks_added_by_tasks)
+{
+	auto scheduler = make_blocking_scheduler();
+	std::vector<int> order;
+	scheduler->add_task([&]
+	                    {
+		                    scheduler->add_task([&] { order.push_back(2); });
+		                    order.push_back(1);
+	                    });
+	BOOST_CHECK((order == std::vector<int>{1, 2}));
+}
+
+BOOST_AUTO_TEST_CASE(test_throwing_task)
+{
+	auto scheduler = make_blocking_scheduler();
+	bool deferred_ran = false;
+	BOOST_CHECK_THROW(scheduler->add_task([&]
+	                    {
+		                    scheduler->add_task([&] { deferred_ran = true; });
+		                    throw std::runtime_error{"task failed"};
+	                    }),
+	                  std::runtime_error);
+	BOOST_CHECK(!deferred_ran);
+
+	// tasks added after the failed task still run.
+	auto number = 0;
+	scheduler->add_task([&] { number = 1; });
+	BOOST_CHECK_EQUAL(number, 1);
+	BOOST_CHECK(!deferred_ran);
+}
 BOOST_AUTO_TEST_SUITE_END()
 
@@ -0,0 +1,144 @@
+#include <boost/test/unit_test.hpp>
+
+#include <flexcore/scheduler/cyclecontrol.hpp>
+#include <flexcore/utils/profiling/profiler.hpp>
+
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace fc;
+
+namespace
+{
+std::string trace()
+{
+	std::stringstream out;
+	profiler::get().write_trace(out);
+	return out.str();
+}
+
+bool contains(const std::string& str, const std::string& part)
+{
+	return str.find(part) != std::string::npos;
+}
+}
+
+BOOST_AUTO_TEST_SUITE(test_profiler)
+
+BOOST_AUTO_TEST_CASE(test_not_recording)
+{
+	auto& p = profiler::get();
+	p.start();
+	p.stop();
+	const auto id = p.intern("ignored");
+	{
+		const profile_scope scope{trace_category::task, id};
+	}
+	BOOST_CHECK_EQUAL(p.nr_of_spans(), 0);
+	BOOST_CHECK(!contains(trace(), "ignored"));
+}
+
+BOOST_AUTO_TEST_CASE(test_thread_tracks)
+{
+	auto& p = profiler::get();
+	const auto id = p.intern("span \"a\"");
+	BOOST_CHECK_EQUAL(id, p.intern("span \"a\""));
+
+	p.start();
+	{
+		const profile_scope scope{trace_category::task, id};
+	}
+	std::thread other{[&p, id]()
+			{
+				p.name_thread("other thread");
+				const profile_scope scope{trace_category::work_tick, id};
+			}};
+	other.join();
+	p.stop();
+
+	BOOST_CHECK_EQUAL(p.nr_of_spans(), 2);
+	BOOST_CHECK_EQUAL(p.nr_of_dropped_spans(), 0);
+	const auto json = trace();
+	BOOST_CHECK(contains(json, "\"traceEvents\":["));
+	BOOST_CHECK(contains(json, "\"name\":\"other thread\""));
+	BOOST_CHECK(contains(json, "\"name\":\"span \\\"a\\\"\",\"cat\":\"task\",\"ph\":\"X\""));
+	BOOST_CHECK(contains(json, "\"cat\":\"work_tick\""));
+
+	// spans of the previous recording are discarded on start.
+	p.start();
+	p.stop();
+	BOOST_CHECK_EQUAL(p.nr_of_spans(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_dropped_spans)
+{
+	auto& p = profiler::get();
+	const auto id = p.intern("dropped");
+	p.start(2);
+	for (int i = 0; i != 5; ++i)
+		const profile_scope scope{trace_category::task, id};
+	p.stop();
+	BOOST_CHECK_EQUAL(p.nr_of_spans(), 2);
+	BOOST_CHECK_EQUAL(p.nr_of_dropped_spans(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(test_exited_threads)
+{
+	auto& p = profiler::get();
+	const auto id = p.intern("short lived");
+	const auto record_in_thread = [&p, id]()
+	{
+		std::thread short_lived{[&p, id]()
+				{
+					const profile_scope scope{trace_category::task, id};
+				}};
+		short_lived.join();
+	};
+
+	p.start();
+	record_in_thread();
+	p.stop();
+	const auto buffers = p.nr_of_thread_buffers();
+
+	// buffers of exited threads are reused once their spans are discarded.
+	for (int i = 0; i != 10; ++i)
+	{
+		p.start();
+		record_in_thread();
+		p.stop();
+		BOOST_CHECK_EQUAL(p.nr_of_spans(), 1);
+	}
+	BOOST_CHECK_EQUAL(p.nr_of_thread_buffers(), buffers);
+
+	// spans of exited threads are kept until the next recording.
+	p.start();
+	record_in_thread();
+	record_in_thread();
+	p.stop();
+	BOOST_CHECK_EQUAL(p.nr_of_spans(), 2);
+	BOOST_CHECK_LE(p.nr_of_thread_buffers(), buffers + 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_periodic_tasks)
+{
+	auto region = std::make_shared<parallel_region>("profiled_region",
+			thread::cycle_control::fast_tick);
+	thread::periodic_task region_task{region};
+	thread::periodic_task plain_task{[](){}};
+
+	auto& p = profiler::get();
+	p.start();
+	region_task.send_switch_tick();
+	region_task();
+	plain_task();
+	p.stop();
+
+	BOOST_CHECK_EQUAL(p.nr_of_spans(), 3);
+	const auto json = trace();
+	BOOST_CHECK(contains(json, "\"name\":\"profiled_region\",\"cat\":\"switch_tick\""));
+	BOOST_CHECK(contains(json, "\"name\":\"profiled_region\",\"cat\":\"work_tick\""));
+	BOOST_CHECK(contains(json, "\"name\":\"periodic_task\",\"cat\":\"task\""));
+}
+
+BOOST_AUTO_TEST_SUITE_END()